@@ -0,0 +1,521 @@
+#include "lib/BPMNParser.h"
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <ranges>
+#include <atomic>
+#include <functional>
+
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMNamedNodeMap.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+using namespace xercesc;
+using namespace std;
+
+// Peak resident set size of this process in kilobytes
+long peakRSS() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// Create XML objects from the file using the SAX2 based loader.
+void loadObjects(const string& filename) {
+  unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+}
+
+// Legacy loader which builds a Xerces DOM of the file and copies it into XML objects afterwards,
+// i.e., the entire DOM is kept in memory until all objects are created.
+struct DOMLoader : XML::XMLObject {
+  static string transcode(const XMLCh* value) {
+    if ( !value ) {
+      return "";
+    }
+    char* cString = XMLString::transcode(value);
+    string result(cString);
+    XMLString::release(&cString);
+    return result;
+  }
+
+  static XML::XMLObject* copy(const DOMElement* domElement) {
+    XML::ElementData element;
+    element.xmlns = transcode(domElement->getNamespaceURI());
+    element.prefix = transcode(domElement->getPrefix());
+    element.elementName = transcode(domElement->getLocalName());
+
+    DOMNamedNodeMap* domAttributes = domElement->getAttributes();
+    for ( XMLSize_t i = 0; i < domAttributes->getLength(); i++ ) {
+      DOMNode* item = domAttributes->item(i);
+      XML::Namespace attributeXmlns = item->getNamespaceURI() ? XML::Namespace(transcode(item->getNamespaceURI())) : element.xmlns;
+      element.attributes.push_back( { attributeXmlns, transcode(item->getPrefix()), transcode(item->getLocalName()), XML::Value(transcode(item->getNodeValue())) } );
+    }
+
+    for ( DOMElement* child = domElement->getFirstElementChild(); child; child = child->getNextElementSibling() ) {
+      element.children.push_back(XML::Children::value_type(copy(child)));
+    }
+    if ( element.children.empty() ) {
+      element.textContent = transcode(domElement->getTextContent());
+    }
+    return createObject(element);
+  }
+};
+
+// Create XML objects from the file by building a Xerces DOM and copying it into XML objects.
+void loadDOM(const string& filename) {
+  XMLPlatformUtils::Initialize();
+  {
+    XercesDOMParser parser;
+    parser.setDoNamespaces(true);
+    parser.parse(filename.c_str());
+    if ( !parser.getDocument() || !parser.getDocument()->getDocumentElement() ) {
+      throw runtime_error("Failed to parse XML");
+    }
+    unique_ptr<XML::XMLObject> root(DOMLoader::copy(parser.getDocument()->getDocumentElement()));
+  }
+  XMLPlatformUtils::Terminate();
+}
+
+// Create a BPMN document with a process containing as many tasks as needed to reach the given size.
+string syntheticDocument(size_t size) {
+  string xml = "<bpmn:definitions xmlns:bpmn=\"http://www.omg.org/spec/BPMN/20100524/MODEL\" id=\"Definitions_1\"><bpmn:process id=\"Process_1\">";
+  string end = "</bpmn:process></bpmn:definitions>";
+  for ( size_t i = 0; xml.size() + end.size() < size; i++ ) {
+    xml += "<bpmn:task id=\"Task_" + to_string(i) + "\" name=\"Task " + to_string(i) + "\"/>";
+  }
+  return xml + end;
+}
+
+// Compare the per-document cost of createFromString with a reused parser context.
+void compareContext() {
+  for ( size_t size : { 1000, 100000, 10000000 } ) {
+    string xml = syntheticDocument(size);
+    unsigned int repetitions = max<size_t>(1, 10000000 / size);
+
+    auto start = chrono::steady_clock::now();
+    for ( unsigned int i = 0; i < repetitions; i++ ) {
+      unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromString(xml));
+    }
+    auto end = chrono::steady_clock::now();
+    double withoutContext = chrono::duration<double, micro>(end - start).count() / repetitions;
+
+    XML::ParserContext context;
+    start = chrono::steady_clock::now();
+    for ( unsigned int i = 0; i < repetitions; i++ ) {
+      unique_ptr<XML::XMLObject> root(context.parseString(xml));
+    }
+    end = chrono::steady_clock::now();
+    double withContext = chrono::duration<double, micro>(end - start).count() / repetitions;
+
+    cout << xml.size() << " bytes: " << withoutContext << " us per document with createFromString, " << withContext << " us per document with ParserContext" << endl;
+  }
+}
+
+// Conversions of XML::Value before as<T>() and tryAs<T>() were provided, used as baseline.
+int legacyInt(const XML::Value& value) { try { return stoi(string(value.value)); } catch(...) { throw runtime_error("Cannot convert '" + string(value.value) + "' to int"); } }
+double legacyDouble(const XML::Value& value) { try { return stod(string(value.value)); } catch(...) { throw runtime_error("Cannot convert '" + string(value.value) + "' to double"); } }
+
+// Report the time per conversion of the given function applied to all values.
+template<typename Function>
+void measure(const string& name, const vector<XML::Value>& values, Function convert) {
+  size_t repetitions = 1000000 / values.size();
+  double sum = 0;
+  size_t failed = 0;
+  auto start = chrono::steady_clock::now();
+  for ( size_t i = 0; i < repetitions; i++ ) {
+    for ( auto& value : values ) {
+      try {
+        sum += convert(value);
+      }
+      catch ( const exception& ) {
+        failed++;
+      }
+    }
+  }
+  auto end = chrono::steady_clock::now();
+  double nanoseconds = chrono::duration<double, nano>(end - start).count() / (repetitions * values.size());
+  cout << name << ": " << nanoseconds << " ns per conversion (checksum " << sum << ", " << failed << " failed)" << endl;
+}
+
+// Compare the conversions of attribute values with the operators used before XML::Value provided as<T>() and tryAs<T>().
+void compareValues() {
+  vector<XML::Value> numbers, dirty;
+  for ( int i = 0; i < 1000; i++ ) {
+    numbers.emplace_back(string(to_string(i * 7) + "." + to_string(i % 10)));
+    dirty.emplace_back(string(i % 2 ? to_string(i) : "n/a"));
+  }
+  vector<XML::Value> same(1000, XML::Value(string("1234.5")));
+
+  measure("double, legacy operator", numbers, [](const XML::Value& value) { return legacyDouble(value); });
+  measure("double, as<double>()", numbers, [](const XML::Value& value) { return value.as<double>(); });
+  measure("double, same value, legacy operator", same, [](const XML::Value& value) { return legacyDouble(value); });
+  measure("double, same value, as<double>()", same, [](const XML::Value& value) { return value.as<double>(); });
+  measure("int, 50% invalid, legacy operator", dirty, [](const XML::Value& value) { return legacyInt(value); });
+  measure("int, 50% invalid, as<int>()", dirty, [](const XML::Value& value) { return value.as<int>(); });
+  measure("int, 50% invalid, tryAs<int>()", dirty, [](const XML::Value& value) { return value.tryAs<int>().value_or(0); });
+
+  XML::Value value(0);
+  size_t repetitions = 1000000;
+  auto start = chrono::steady_clock::now();
+  for ( size_t i = 0; i < repetitions; i++ ) {
+    value.value = to_string(i * 0.125);
+  }
+  auto end = chrono::steady_clock::now();
+  cout << "assign double, legacy operator: " << chrono::duration<double, nano>(end - start).count() / repetitions << " ns per assignment" << endl;
+  start = chrono::steady_clock::now();
+  for ( size_t i = 0; i < repetitions; i++ ) {
+    value = i * 0.125;
+  }
+  end = chrono::steady_clock::now();
+  cout << "assign double, operator=: " << chrono::duration<double, nano>(end - start).count() / repetitions << " ns per assignment" << endl;
+}
+
+// Report the time per traversal of the given function applied to the XML-tree.
+template<typename Function>
+void measure(const string& name, size_t repetitions, Function traverse) {
+  size_t found = 0;
+  auto start = chrono::steady_clock::now();
+  for ( size_t i = 0; i < repetitions; i++ ) {
+    found += traverse();
+  }
+  auto end = chrono::steady_clock::now();
+  double microseconds = chrono::duration<double, micro>(end - start).count() / repetitions;
+  cout << name << ": " << microseconds << " us per traversal (" << found / repetitions << " found)" << endl;
+}
+
+// Compare hand-written traversals of the XML-tree with the equivalent queries.
+void compareQueries(const string& filename, size_t repetitions) {
+  using namespace XML::bpmn;
+  unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+
+  measure("flow nodes, getChildren<T>()", repetitions, [&root]() {
+    size_t count = 0;
+    for ( tProcess& process : root->getChildren<tProcess>() ) {
+      count += process.getChildren<tFlowNode>().size();
+    }
+    return count;
+  });
+  XML::Query flowNodes("type(tProcess)/type(tFlowNode)");
+  measure("flow nodes, query", repetitions, [&]() { return flowNodes.count(*root); });
+
+  measure("incoming arcs, getChildren<T>()", repetitions, [&root]() {
+    size_t count = 0;
+    for ( tProcess& process : root->getChildren<tProcess>() ) {
+      for ( tFlowNode& node : process.getChildren<tFlowNode>() ) {
+        count += node.incoming.size();
+      }
+    }
+    return count;
+  });
+  XML::Query incoming("type(tProcess)/type(tFlowNode)/incoming");
+  measure("incoming arcs, query", repetitions, [&]() { return incoming.count(*root); });
+
+  measure("sequence flows, find<T>()", repetitions, [&root]() { return root->find<tSequenceFlow>().size(); });
+  XML::Query sequenceFlows("//type(tSequenceFlow)");
+  measure("sequence flows, query", repetitions, [&]() { return sequenceFlows.count(*root); });
+
+  measure("query compilation", repetitions, []() { XML::Query query("//type(tProcess)/type(tFlowNode)[@name!='']/outgoing"); return 1; });
+}
+
+// Compare traversals of the XML-tree with traversals of its frozen copy.
+void compareFrozen(const string& filename, size_t repetitions) {
+  using namespace XML::bpmn;
+  unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+
+  auto start = chrono::steady_clock::now();
+  XML::FrozenDocument document = root->freeze();
+  auto end = chrono::steady_clock::now();
+  cout << "freeze: " << chrono::duration<double, micro>(end - start).count() << " us for " << document.size() << " elements" << endl;
+
+  measure("flow nodes and incoming arcs, objects", repetitions, [&root]() {
+    size_t count = 0;
+    for ( tFlowNode& node : root->descendants<tFlowNode>() ) {
+      count += 1 + node.incoming.size();
+    }
+    return count;
+  });
+  measure("flow nodes and incoming arcs, frozen", repetitions, [&document]() {
+    size_t count = 0;
+    for ( XML::Frozen<tFlowNode> node : document.root().descendants<tFlowNode>() ) {
+      count += 1 + ranges::distance(node.incoming());
+    }
+    return count;
+  });
+
+  XML::AttributeName id("id");
+  measure("ids of all elements, objects", repetitions, [&root, &id]() {
+    size_t count = 0;
+    for ( const XML::XMLObject& object : root->descendants<XML::XMLObject>() ) {
+      count += object.getOptionalAttributeByName(id).has_value();
+    }
+    return count;
+  });
+  measure("ids of all elements, frozen", repetitions, [&document, &id]() {
+    size_t count = 0;
+    for ( XML::Frozen<XML::XMLObject> element : document.root().descendants<XML::XMLObject>() ) {
+      count += element.getOptionalAttributeByName(id).has_value();
+    }
+    return count;
+  });
+}
+
+// Compare the time to the first query after loading the file with the time after mapping a snapshot of it.
+void compareSnapshot(const string& filename, size_t repetitions) {
+  using namespace XML::bpmn;
+  string snapshot = filename + ".snapshot";
+  {
+    unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+    root->freeze().writeSnapshot(snapshot);
+  }
+
+  measure("createFromFile and first query", repetitions, [&filename]() {
+    unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+    return ranges::distance(root->descendants<tFlowNode>());
+  });
+  measure("mapSnapshot and first query", repetitions, [&snapshot]() {
+    XML::FrozenDocument document = XML::FrozenDocument::mapSnapshot(snapshot);
+    return ranges::distance(document.root().descendants<tFlowNode>());
+  });
+}
+
+// Count the objects of the XML-tree which are already created and those of them in the BPMN DI namespace.
+void countCreated(const XML::XMLObject& object, size_t& created, size_t& diagram) {
+  created++;
+  if ( object.xmlns == "http://www.omg.org/spec/BPMN/20100524/DI" ) {
+    diagram++;
+  }
+  for ( size_t i = 0; i < object.children.size(); i++ ) {
+    if ( object.children.isCreated(i) ) {
+      countCreated(object.children.object(i), created, diagram);
+    }
+  }
+}
+
+// Compare eager and lazy construction when only the incoming arcs of the flow nodes are visited through the members.
+void compareLazy(const string& filename, size_t repetitions) {
+  using namespace XML::bpmn;
+  for ( bool lazy : { false, true } ) {
+    XML::ParserContext context;
+    context.setLazyConstruction(lazy);
+    size_t found = 0;
+    size_t created = 0;
+    size_t diagram = 0;
+    auto start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < repetitions; i++ ) {
+      unique_ptr<XML::XMLObject> root(context.parseFile(filename));
+      found = 0;
+      for ( tRootElement& rootElement : root->get<tDefinitions>()->rootElement ) {
+        if ( tProcess* process = rootElement.is<tProcess>() ) {
+          for ( tFlowElement& flowElement : process->flowElement ) {
+            if ( tFlowNode* node = flowElement.is<tFlowNode>() ) {
+              found += node->incoming.size();
+            }
+          }
+        }
+      }
+      if ( i + 1 == repetitions ) {
+        created = diagram = 0;
+        countCreated(*root, created, diagram);
+      }
+    }
+    auto end = chrono::steady_clock::now();
+    double milliseconds = chrono::duration<double, milli>(end - start).count() / repetitions;
+    cout << ( lazy ? "lazy" : "eager" ) << ": " << milliseconds << " ms per document (" << found << " found), " << created << " objects created, " << diagram << " of them from BPMN DI" << endl;
+  }
+}
+
+// Report the time to load the file when constructing large subtrees concurrently with an increasing number of threads.
+void compareParallel(const string& filename, size_t threshold) {
+  unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+  double baseline = 0;
+  for ( unsigned int threads = 1; ; threads = min(2 * threads, maxThreads) ) {
+    XML::ParserContext context;
+    context.setParallelConstruction(threshold, threads);
+    unique_ptr<XML::XMLObject> warmup(context.parseFile(filename));
+    size_t repetitions = 10;
+    auto start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < repetitions; i++ ) {
+      unique_ptr<XML::XMLObject> root(context.parseFile(filename));
+    }
+    auto end = chrono::steady_clock::now();
+
+    double milliseconds = chrono::duration<double, milli>(end - start).count() / repetitions;
+    if ( threads == 1 ) {
+      baseline = milliseconds;
+    }
+    cout << threads << " threads: " << milliseconds << " ms per document, speedup " << baseline / milliseconds << endl;
+    if ( threads == maxThreads ) {
+      break;
+    }
+  }
+}
+
+// Report the throughput of loading the file many times with an increasing number of threads.
+void compareThreads(const string& filename, size_t count) {
+  vector<string> filenames(count, filename);
+  unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+  double baseline = 0;
+  for ( unsigned int threads = 1; ; threads = min(2 * threads, maxThreads) ) {
+    auto start = chrono::steady_clock::now();
+    size_t failed = 0;
+    XML::XMLObject::createFromFiles(filenames, [&failed](XML::LoadResult& result) { failed += !result.root; }, threads);
+    auto end = chrono::steady_clock::now();
+
+    double documentsPerSecond = count / chrono::duration<double>(end - start).count();
+    if ( threads == 1 ) {
+      baseline = documentsPerSecond;
+    }
+    cout << threads << " threads: " << documentsPerSecond << " documents per second, speedup " << documentsPerSecond / baseline;
+    if ( failed ) {
+      cout << ", " << failed << " failed";
+    }
+    cout << endl;
+    if ( threads == maxThreads ) {
+      break;
+    }
+  }
+}
+
+// Compare the serialization of the XML-tree to strings with the serialization to a file descriptor.
+void compareSerialize(const string& filename, size_t repetitions) {
+  unique_ptr<XML::XMLObject> root(XML::XMLObject::createFromFile(filename));
+  measure("stringify", repetitions, [&root]() { return root->stringify().size(); });
+  measure("format", repetitions, [&root]() { return root->format().size(); });
+  int fileDescriptor = open("/dev/null", O_WRONLY);
+  measure("serializer to file descriptor", repetitions, [&root, fileDescriptor]() {
+    XML::Serializer(fileDescriptor).write(*root);
+    return 1;
+  });
+  close(fileDescriptor);
+}
+
+// Compare handling requests for the same file by loading it each time with handling them by a shared cache.
+void compareCache(const string& filename, size_t requests) {
+  unsigned int threads = max(1u, thread::hardware_concurrency());
+  auto handle = [&](const function<void()>& request) {
+    atomic<size_t> next = 0;
+    vector<std::thread> workers;
+    auto start = chrono::steady_clock::now();
+    for ( unsigned int i = 0; i < threads; i++ ) {
+      workers.emplace_back([&]() {
+        while ( next++ < requests ) {
+          request();
+        }
+      });
+    }
+    for ( auto& worker : workers ) {
+      worker.join();
+    }
+    auto end = chrono::steady_clock::now();
+    return requests / chrono::duration<double>(end - start).count();
+  };
+
+  cout << "createFromFile: " << handle([&filename]() { loadObjects(filename); }) << " requests per second" << endl;
+
+  XML::DocumentCache cache(256 * 1024 * 1024);
+  cout << "cache: " << handle([&filename, &cache]() { cache.get(filename); }) << " requests per second" << endl;
+  XML::DocumentCache::Statistics statistics = cache.getStatistics();
+  cout << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions << " evictions, " << statistics.bytes << " bytes cached" << endl;
+}
+
+int main(int argc, char **argv) {
+  if ( argc == 2 && string(argv[1]) == "context" ) {
+    compareContext();
+    return 0;
+  }
+
+  if ( argc == 2 && string(argv[1]) == "values" ) {
+    compareValues();
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "query" ) {
+    compareQueries(argv[2], argc > 3 ? stoul(argv[3]) : 1000);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "frozen" ) {
+    compareFrozen(argv[2], argc > 3 ? stoul(argv[3]) : 1000);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "snapshot" ) {
+    compareSnapshot(argv[2], argc > 3 ? stoul(argv[3]) : 100);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "serialize" ) {
+    compareSerialize(argv[2], argc > 3 ? stoul(argv[3]) : 100);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "cache" ) {
+    compareCache(argv[2], argc > 3 ? stoul(argv[3]) : 1000);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "lazy" ) {
+    compareLazy(argv[2], argc > 3 ? stoul(argv[3]) : 100);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "parallel" ) {
+    compareParallel(argv[2], argc > 3 ? stoul(argv[3]) : 10000);
+    return 0;
+  }
+
+  if ( argc >= 3 && string(argv[1]) == "threads" ) {
+    compareThreads(argv[2], argc > 3 ? stoul(argv[3]) : 1000);
+    return 0;
+  }
+
+  if ( argc < 3 ) {
+    cout << "Usage: " << argv[0] << " objects|dom <bpmn-file> [repetitions]" << endl;
+    cout << "       " << argv[0] << " context" << endl;
+    cout << "       " << argv[0] << " values" << endl;
+    cout << "       " << argv[0] << " query <bpmn-file> [repetitions]" << endl;
+    cout << "       " << argv[0] << " frozen <bpmn-file> [repetitions]" << endl;
+    cout << "       " << argv[0] << " snapshot <bpmn-file> [repetitions]" << endl;
+    cout << "       " << argv[0] << " lazy <bpmn-file> [repetitions]" << endl;
+    cout << "       " << argv[0] << " threads <bpmn-file> [documents]" << endl;
+    cout << "       " << argv[0] << " parallel <bpmn-file> [threshold]" << endl;
+    cout << "       " << argv[0] << " cache <bpmn-file> [requests]" << endl;
+    cout << "       " << argv[0] << " serialize <bpmn-file> [repetitions]" << endl;
+    cout << "Peak RSS is reported per process, run each mode separately to compare them." << endl;
+    return 0;
+  }
+
+  string mode = argv[1];
+  string filename = argv[2];
+  unsigned int repetitions = ( argc > 3 ? stoul(argv[3]) : 1 );
+
+  auto start = chrono::steady_clock::now();
+  for ( unsigned int i = 0; i < repetitions; i++ ) {
+    if ( mode == "objects" ) {
+      loadObjects(filename);
+    }
+    else if ( mode == "dom" ) {
+      loadDOM(filename);
+    }
+    else {
+      cerr << "Unknown mode '" << mode << "'" << endl;
+      return 1;
+    }
+  }
+  auto end = chrono::steady_clock::now();
+
+  double milliseconds = chrono::duration<double, milli>(end - start).count();
+  cout << mode << ": " << milliseconds / repetitions << " ms per document, peak RSS " << peakRSS() << " kB" << endl;
+
+  return 0;
+}
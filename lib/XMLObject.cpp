@@ -1,9 +1,44 @@
 #include "XMLObject.h"
-#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/BinInputStream.hpp>
 #include <xercesc/sax/InputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/LocalFileInputSource.hpp>
 #include <iostream>
 #include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_set>
+#include <charconv>
+#include <cctype>
+#include <limits>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <utility>
+
+#ifdef __SSE2__
+ #include <emmintrin.h>
+#endif
+
+#ifndef WIN32
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#else
+ #include <io.h>
+#endif
 
 namespace XML {
 
@@ -33,226 +68,2306 @@ public:
   IStreamInputSource(std::istream &is) : InputSource(), is(is) {};
 };
 
-std::string transcode(const XMLCh* xmlChStr) {
-  char* cStr = xercesc::XMLString::transcode(xmlChStr);
-  if (!cStr) {
-      throw std::runtime_error("Failed to transcode XML string");
+// Input source providing the chunks pushed to a PushParser. Reading blocks until further chunks
+// are pushed or the input is closed.
+class PushInputSource : public xercesc::InputSource {
+public:
+  PushInputSource() : InputSource() {};
+
+  void push(std::string_view chunk) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      chunks.emplace_back(chunk);
+      available += chunk.size();
+    }
+    condition.notify_one();
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    condition.notify_one();
+  }
+
+  xercesc::BinInputStream* makeStream() const {
+    return new PushBinInputStream(const_cast<PushInputSource&>(*this));
+  }
+
+private:
+  class PushBinInputStream : public xercesc::BinInputStream {
+    PushInputSource& source;
+    XMLFilePos position = 0;
+  public:
+    PushBinInputStream(PushInputSource& source) : xercesc::BinInputStream(), source(source) {};
+    XMLFilePos curPos(void) const { return position; };
+    XMLSize_t readBytes(XMLByte* const buf, const XMLSize_t max) {
+      XMLSize_t size = source.read(buf, max, position == 0);
+      position += size;
+      return size;
+    };
+    const XMLCh* getContentType() const {
+      return NULL;
+    };
+  };
+
+  // Copies available bytes into the buffer and waits only if no bytes are available. As the
+  // encoding and XML declaration are detected from the first bytes, the first read waits for
+  // a minimum number of bytes.
+  XMLSize_t read(XMLByte* buffer, XMLSize_t max, bool first) {
+    const size_t minimum = first ? std::min<size_t>(max, 128) : 1;
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this,minimum]() { return closed || available >= minimum; });
+    XMLSize_t size = 0;
+    while ( size < max && !chunks.empty() ) {
+      std::string& chunk = chunks.front();
+      size_t count = std::min<size_t>(max - size, chunk.size() - offset);
+      std::copy(chunk.data() + offset, chunk.data() + offset + count, buffer + size);
+      size += count;
+      offset += count;
+      if ( offset == chunk.size() ) {
+        chunks.pop_front();
+        offset = 0;
+      }
+    }
+    available -= size;
+    return size;
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::string> chunks;
+  size_t offset = 0; // position in the first chunk
+  size_t available = 0; // number of bytes not yet read
+  bool closed = false;
+};
+
+#ifndef WIN32
+// Utility class mapping a file into memory for reading it in place.
+class MappedFile {
+  void* data = MAP_FAILED;
+  size_t size = 0;
+public:
+  MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if ( fd < 0 ) {
+      throw std::runtime_error("Failed to open XML-file '" + filename + "'");
+    }
+    struct stat status;
+    if ( fstat(fd, &status) == 0 && status.st_size > 0 ) {
+      size = (size_t)status.st_size;
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if ( data == MAP_FAILED ) {
+      throw std::runtime_error("Failed to load XML-file '" + filename + "'");
+    }
+    // the file is read sequentially
+    madvise(data, size, MADV_SEQUENTIAL);
+  };
+  ~MappedFile() {
+    munmap(data, size);
+  };
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  std::string_view view() const { return std::string_view((const char*)data, size); };
+};
+#endif
+
+// Returns the number of bytes required to encode the UTF-16 string as UTF-8.
+size_t utf8Length(const XMLCh* xmlChStr, size_t length) {
+  size_t result = 0;
+  for (size_t i = 0; i < length; i++) {
+    char32_t c = (char32_t)xmlChStr[i];
+    if ( c < 0x80 ) {
+      result += 1;
+    }
+    else if ( c < 0x800 ) {
+      result += 2;
+    }
+    else if ( c >= 0xD800 && c < 0xDC00 && i + 1 < length && (char32_t)xmlChStr[i+1] >= 0xDC00 && (char32_t)xmlChStr[i+1] < 0xE000 ) {
+      // surrogate pair
+      result += 4;
+      i++;
+    }
+    else {
+      // unpaired surrogates are replaced by U+FFFD
+      result += 3;
+    }
   }
-  std::string result(cStr);
-  xercesc::XMLString::release(&cStr);
   return result;
 }
 
-XMLObject* XMLObject::createFromStream(std::istream& xmlStream) {
-  // std::cout << "Create XML object from input stream" << std::endl;
-  xercesc::XMLPlatformUtils::Initialize();
-  std::unique_ptr<xercesc::XercesDOMParser> parser = std::make_unique<xercesc::XercesDOMParser>();
-  parser->setDoNamespaces(true);
-  parser->parse(IStreamInputSource(xmlStream));
-
-  xercesc::DOMDocument* document = parser->getDocument();
-  if (!document) {
-    parser.reset(); // delete unique_ptr to parser before calling Terminate
-    xercesc::XMLPlatformUtils::Terminate();
-    throw std::runtime_error("Failed to parse XML");
-  }
-
-  xercesc::DOMElement* rootElement = document->getDocumentElement();
-  if (!rootElement) {
-    parser.reset(); // delete unique_ptr to parser before calling Terminate
-    xercesc::XMLPlatformUtils::Terminate();
-    throw std::runtime_error("Failed to get root element of XML");
+/**
+ * Appends the UTF-16 string to the given string using UTF-8 encoding.
+ *
+ * Runs of ASCII characters are narrowed eight characters at a time where SSE2 is available.
+ * The remainder is only measured and encoded character by character when the first
+ * non-ASCII character is found.
+ */
+template<typename String>
+void appendUTF8(String& result, const XMLCh* xmlChStr, size_t length) {
+  size_t offset = result.size();
+  // ASCII characters require one byte each
+  result.resize(offset + length);
+  char* out = result.data() + offset;
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i nonASCII = _mm_set1_epi16((short)0xFF80);
+  for ( ; i + 8 <= length; i += 8 ) {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)(xmlChStr + i));
+    if ( _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chunk, nonASCII), _mm_setzero_si128())) != 0xFFFF ) {
+      break;
+    }
+    _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(chunk, chunk));
+    out += 8;
+  }
+#endif
+  for ( ; i < length && (char32_t)xmlChStr[i] < 0x80; i++ ) {
+    *out++ = (char)xmlChStr[i];
+  }
+  if ( i == length ) {
+    return;
   }
 
-  std::string rootName = transcode(rootElement->getLocalName());
-  XMLObject* object = createObject(rootElement);
-  parser.reset(); // delete unique_ptr to parser before calling Terminate
-  xercesc::XMLPlatformUtils::Terminate();
-  return object;
+  size_t ascii = (size_t)(out - result.data());
+  result.resize(ascii + utf8Length(xmlChStr + i, length - i));
+  out = result.data() + ascii;
+  for ( ; i < length; i++ ) {
+    char32_t c = (char32_t)xmlChStr[i];
+    if ( c < 0x80 ) {
+      *out++ = (char)c;
+      continue;
+    }
+    if ( c < 0x800 ) {
+      *out++ = (char)(0xC0 | (c >> 6));
+      *out++ = (char)(0x80 | (c & 0x3F));
+      continue;
+    }
+    if ( c >= 0xD800 && c < 0xE000 ) {
+      if ( c < 0xDC00 && i + 1 < length && (char32_t)xmlChStr[i+1] >= 0xDC00 && (char32_t)xmlChStr[i+1] < 0xE000 ) {
+        c = 0x10000 + ((c - 0xD800) << 10) + ((char32_t)xmlChStr[++i] - 0xDC00);
+        *out++ = (char)(0xF0 | (c >> 18));
+        *out++ = (char)(0x80 | ((c >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((c >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (c & 0x3F));
+        continue;
+      }
+      c = 0xFFFD;
+    }
+    *out++ = (char)(0xE0 | (c >> 12));
+    *out++ = (char)(0x80 | ((c >> 6) & 0x3F));
+    *out++ = (char)(0x80 | (c & 0x3F));
+  }
 }
 
-XMLObject* XMLObject::createFromString(const std::string& xmlString) {
-  // std::cout << "Create XML object from string" << std::endl;
-  std::istringstream iss(xmlString);
-  return createFromStream(iss);
+std::string transcode(const XMLCh* xmlChStr) {
+  std::string result;
+  if ( xmlChStr ) {
+    appendUTF8(result, xmlChStr, xercesc::XMLString::stringLen(xmlChStr));
+  }
+  return result;
 }
 
-XMLObject* XMLObject::createFromFile(const std::string& filename) {
-  // std::cout << "Create XML object from file" << std::endl;
-  xercesc::XMLPlatformUtils::Initialize();
-  std::unique_ptr<xercesc::XercesDOMParser> parser = std::make_unique<xercesc::XercesDOMParser>();
-  parser->setDoNamespaces(true);
-  XMLCh* xmlFilename = xercesc::XMLString::transcode(filename.c_str());
-  parser->parse(xmlFilename);
-  xercesc::XMLString::release(&xmlFilename);  // Release memory after usage
+// Hash allowing to look up interned names by std::string_view
+struct NameHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+};
 
+// Process-wide table of interned names
+struct NameTable {
+  std::shared_mutex mutex;
+  std::unordered_set<std::string, NameHash, std::equal_to<>> names;
+};
 
-  xercesc::DOMDocument* document = parser->getDocument();
-  if (!document) {
-    parser.reset(); // delete unique_ptr to parser before calling Terminate
-    xercesc::XMLPlatformUtils::Terminate();
-    throw std::runtime_error("Failed to load and parse XML-file");
+const std::string* Name::intern(std::string_view value) {
+  static const std::string emptyName;
+  if ( value.empty() ) {
+    return &emptyName;
   }
 
-  xercesc::DOMElement* rootElement = document->getDocumentElement();
-  if (!rootElement) {
-    parser.reset(); // delete unique_ptr to parser before calling Terminate
-    xercesc::XMLPlatformUtils::Terminate();
-    throw std::runtime_error("Failed to get root element of XML");
+  // the table is created on first use as names are also created during static initialization
+  static NameTable table;
+  {
+    std::shared_lock lock(table.mutex);
+    if ( auto it = table.names.find(value); it != table.names.end() ) {
+      return &*it;
+    }
   }
+  std::unique_lock lock(table.mutex);
+  // the elements of an unordered set are never moved
+  return &*table.names.emplace(value).first;
+}
 
-  std::string rootName = transcode(rootElement->getLocalName());
-  
-  XMLObject* object = createObject(rootElement);
-  parser.reset(); // delete unique_ptr to parser before calling Terminate
-  xercesc::XMLPlatformUtils::Terminate();
-  return object;
+std::pmr::string transcode(const XMLCh* xmlChStr, std::pmr::memory_resource* resource) {
+  std::pmr::string result(resource);
+  if ( xmlChStr ) {
+    appendUTF8(result, xmlChStr, xercesc::XMLString::stringLen(xmlChStr));
+  }
+  return result;
 }
 
+/**
+ * Pool of worker threads executing tasks using work stealing.
+ *
+ * Each worker has its own queue of tasks, and any other thread uses the first queue, i.e., the pool
+ * is meant to be used by one thread besides its workers. Tasks are submitted to the queue of the
+ * submitting thread and taken from its back, while idle threads steal the oldest tasks from the
+ * front of other queues. Thus, the threads only contend for a queue when stealing. Tasks are
+ * submitted as part of a group. A thread waiting for a group executes pending tasks itself, so
+ * that tasks can submit and wait for further tasks without blocking the workers.
+ */
+class TaskPool {
+public:
+  struct Group {
+    std::atomic<size_t> pending = 0;
+    std::mutex mutex; // protects the exception
+    std::exception_ptr exception;
+  };
 
-XMLObject* XMLObject::createObject(const xercesc::DOMElement* element) {
-  Namespace xmlns = transcode(element->getNamespaceURI());
-  ElementName elementName = transcode(element->getLocalName());
-  if ( auto it = factory.find(xmlns + ":" + elementName); it != factory.end() ) { 
-    return it->second(xmlns, elementName, element); 
+  TaskPool(unsigned int threads) : queues(std::make_unique<Queue[]>(std::max(1u, threads))), queueCount(std::max(1u, threads)) {
+    for ( unsigned int i = 1; i < threads; i++ ) {
+      workers.emplace_back([this,i]() { work(i); });
+    }
+  }
+
+  ~TaskPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    sleeping.notify_all();
+    for ( auto& worker : workers ) {
+      worker.join();
+    }
+  }
+
+  void submit(Group& group, std::function<void()> task) {
+    group.pending++;
+    Queue& queue = queues[current()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.emplace_back(&group, std::move(task));
+    }
+    queued++;
+    wake(false);
+  }
+
+  // Waits until all tasks of the group are completed and rethrows the first exception thrown by a task.
+  void wait(Group& group) {
+    size_t index = current();
+    while ( group.pending ) {
+      if ( !runNext(index) ) {
+        sleep([&group]() { return group.pending == 0; });
+      }
+    }
+    if ( group.exception ) {
+      std::rethrow_exception(group.exception);
+    }
   }
-  // std::cout << "Unknown element '" << elementName << "' using 'XMLObject' instead" << std::endl;
-  return createInstance<XMLObject>(xmlns, "XMLObject", element);
-}
 
-XMLObject::XMLObject(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element, const Attributes& defaultAttributes) : xmlns(xmlns), className(className) {
+private:
+  typedef std::pair<Group*, std::function<void()>> Task;
 
-  prefix = transcode(element->getPrefix());
-  elementName = transcode(element->getLocalName());
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
 
-  // set attributes
-  xercesc::DOMNamedNodeMap* elementAttributes = element->getAttributes();
-  for (XMLSize_t i = 0; i < elementAttributes->getLength(); i++) {
-    xercesc::DOMNode* item = elementAttributes->item(i);
-    
-    AttributeName attributeName = transcode(item->getLocalName());
-    // get namespace from atrribute or parent element
-    Namespace attributeXmlns = item->getNamespaceURI() ? transcode(item->getNamespaceURI()) : xmlns;
-    Namespace attributePrefix = item->getPrefix() ? transcode(item->getPrefix()) : "";
-    Value attributeValue(transcode(item->getNodeValue()));
-    attributes.push_back( { attributeXmlns, attributePrefix, attributeName, attributeValue } );
+  // Returns the index of the queue of the calling thread.
+  size_t current() const {
+    return currentPool == this ? currentQueue : 0;
   }
 
-  // add defaults for missing attributes
-  for ( auto& defaultAttribute : defaultAttributes ) {
-    if ( !getOptionalAttributeByName(defaultAttribute.name) ) {
-      attributes.push_back(defaultAttribute);
+  // Takes the most recently submitted task of the own queue or steals the oldest task of another queue.
+  bool take(size_t index, Task& task) {
+    for ( size_t i = 0; i < queueCount; i++ ) {
+      Queue& queue = queues[(index + i) % queueCount];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if ( !queue.tasks.empty() ) {
+        if ( i == 0 ) {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        }
+        else {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+        queued--;
+        return true;
+      }
     }
+    return false;
   }
 
-  // set children
-  for (xercesc::DOMElement *childElement = element->getFirstElementChild(); childElement; childElement = childElement->getNextElementSibling()) {
-    children.push_back(std::unique_ptr<XMLObject>(createObject(childElement)));
+  // Runs the next task, if any.
+  bool runNext(size_t index) {
+    if ( !queued ) {
+      return false;
+    }
+    Task task;
+    if ( !take(index, task) ) {
+      return false;
+    }
+    auto& [group, function] = task;
+    try {
+      function();
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(group->mutex);
+      if ( !group->exception ) {
+        group->exception = std::current_exception();
+      }
+    }
+    // the group must not be accessed after the last task is completed
+    if ( --group->pending == 0 ) {
+      wake(true);
+    }
+    return true;
   }
 
-  if ( children.empty() ) {
-    textContent = transcode(element->getTextContent());
+  // Blocks until a task is submitted, the pool is stopped, or the condition is met.
+  template<typename Condition> void sleep(Condition condition) {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    sleepers++;
+    sleeping.wait(lock, [this,&condition]() { return queued > 0 || stopping || condition(); });
+    sleepers--;
   }
-}
 
+  // Wakes sleeping threads, the mutex is only acquired if a thread is sleeping.
+  void wake(bool all) {
+    if ( sleepers ) {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      if ( all ) {
+        sleeping.notify_all();
+      }
+      else {
+        sleeping.notify_one();
+      }
+    }
+  }
 
-XMLObject& XMLObject::getRequiredChildByName(const ElementName& elementName) {
-  for ( auto& child : children ) {
-    if ( child->elementName == elementName ) {
-      return *child;
+  void work(size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    while ( true ) {
+      if ( !runNext(index) ) {
+        sleep([]() { return false; });
+        if ( stopping && !queued ) {
+          return;
+        }
+      }
     }
   }
-  throw std::runtime_error("Failed to get required child of element '" + elementName + "'");
-}
 
-std::optional< std::reference_wrapper<XMLObject> > XMLObject::getOptionalChildByName(const ElementName& elementName) {
-  for ( auto& child : children ) {
-    if ( child->elementName == elementName ) {
-      return *child;
+  std::unique_ptr<Queue[]> queues;
+  size_t queueCount;
+  std::atomic<size_t> queued = 0; // number of tasks in all queues
+  std::atomic<size_t> sleepers = 0;
+  std::mutex sleepMutex;
+  std::condition_variable sleeping;
+  std::atomic<bool> stopping = false; // set while holding sleepMutex
+  std::vector<std::thread> workers;
+
+  inline static thread_local const TaskPool* currentPool = nullptr;
+  inline static thread_local size_t currentQueue = 0;
+};
+
+/**
+ * SAX2 handler creating XMLObjects directly from the parser events.
+ *
+ * For each open element the handler keeps an ElementData on a stack. When an element is closed,
+ * the respective object is created and added to the children of its parent. Thus, no DOM is
+ * created and each element is visited only once. If an arena is set, all objects and their data
+ * are allocated from the arena.
+ *
+ * Namespaces and element names are dispatched using a two-level table keyed by the UTF-16 strings
+ * provided by the parser. Each table entry holds the interned name and the creator registered
+ * in the factory, so that names are only transcoded the first time they are encountered.
+ * The parser passes the namespace URIs from its URI pool, in which the string of each pool id
+ * keeps its address until the next document. Namespace entries are therefore looked up by the
+ * address of the URI, and the lookup is cleared at the start of each document. Prefixes and
+ * attribute names are not pooled by id and are looked up by their UTF-16 strings.
+ *
+ * In lazy mode, the element data of all elements except the root is kept in the children
+ * of the parent, and the objects are created on first access to the children.
+ *
+ * When streaming, only elements within the outermost elements accepted by `matches` are kept.
+ * Each object created for such an element is passed to the callback and deleted afterwards.
+ *
+ * If a task pool is set, the element data is kept until the end of the document and the objects
+ * are constructed afterwards. Subtrees with at least `threshold` elements are constructed by
+ * separate tasks.
+ */
+class SAX2Handler : public xercesc::DefaultHandler {
+  typedef std::basic_string<XMLCh> XMLChString;
+  typedef std::basic_string_view<XMLCh> XMLChStringView;
+
+  struct XMLChHash {
+    using is_transparent = void;
+    size_t operator()(XMLChStringView value) const { return std::hash<XMLChStringView>()(value); }
+  };
+
+  struct ElementEntry {
+    Namespace xmlns;
+    ElementName elementName;
+    Creator creator;
+    const TypeId* type;
+  };
+
+  struct NamespaceEntry {
+    Namespace xmlns;
+    const std::unordered_map<ElementName, FactoryEntry>* classes;
+    std::unordered_map<XMLChString, ElementEntry, XMLChHash, std::equal_to<>> elements;
+  };
+
+  std::unordered_map<XMLChString, NamespaceEntry, XMLChHash, std::equal_to<>> namespaces;
+  std::unordered_map<const XMLCh*, NamespaceEntry*> uris; // namespace entries by URI pool id of the current document
+  std::unordered_map<XMLChString, Name, XMLChHash, std::equal_to<>> names;
+  std::string scratch;
+  std::vector<ElementData> stack;
+  std::vector<const ElementEntry*> entries; // entries of the open elements
+  std::unique_ptr<XMLObject, Deleter> root;
+
+  // Element of which the object is constructed after the document is parsed
+  struct PendingElement {
+    ElementData element;
+    Creator creator;
+    std::vector<PendingElement> children;
+    size_t size; // number of elements in the subtree
+  };
+  std::vector<std::vector<PendingElement>> pendingChildren;
+  std::optional<PendingElement> pendingRoot;
+
+  bool hasChildren() const {
+    // objects of lazily created children must not be created while parsing
+    return !stack.back().children.objects.empty() || stack.back().children.pending || ( !pendingChildren.empty() && !pendingChildren.back().empty() );
+  }
+
+  std::unique_ptr<XMLObject, Deleter> construct(PendingElement& pending) {
+    std::vector<std::unique_ptr<XMLObject, Deleter>> objects(pending.children.size());
+    TaskPool::Group group;
+    for ( size_t i = 0; i < pending.children.size(); i++ ) {
+      if ( pending.children[i].size >= threshold ) {
+        taskPool->submit(group, [this,&pending,&objects,i]() { objects[i] = construct(pending.children[i]); });
+      }
+    }
+
+    std::exception_ptr exception;
+    try {
+      for ( size_t i = 0; i < pending.children.size(); i++ ) {
+        if ( pending.children[i].size < threshold ) {
+          objects[i] = construct(pending.children[i]);
+        }
+      }
+    }
+    catch (...) {
+      exception = std::current_exception();
+    }
+    // tasks refer to local variables and must be completed in any case
+    taskPool->wait(group);
+    if ( exception ) {
+      std::rethrow_exception(exception);
+    }
+
+    pending.element.children.reserve(objects.size());
+    for ( auto& object : objects ) {
+      pending.element.children.push_back(std::move(object));
     }
+    return std::unique_ptr<XMLObject, Deleter>(XMLObject::createObject(pending.creator, pending.element), Deleter(arena != nullptr));
   }
-  return std::nullopt;
-}
 
-std::vector< std::reference_wrapper<XMLObject> > XMLObject::getChildrenByName(const ElementName& elementName) {
-  std::vector< std::reference_wrapper<XMLObject> > result;
-  for ( auto& child : children ) {
-    if ( child->elementName == elementName ) {
-      result.push_back(*child);
+  Name toName(XMLChStringView source) {
+    scratch.clear();
+    appendUTF8(scratch, source.data(), source.size());
+    return Name(scratch);
+  }
+
+  const Name& nameOf(XMLChStringView source) {
+    auto it = names.find(source);
+    if ( it == names.end() ) {
+      it = names.emplace(source, toName(source)).first;
     }
+    return it->second;
   }
-  return result;
+
+  NamespaceEntry& namespaceOf(const XMLCh* uri) {
+    auto [it, inserted] = uris.try_emplace(uri, nullptr);
+    if ( inserted ) {
+      auto it2 = namespaces.find(XMLChStringView(uri));
+      if ( it2 == namespaces.end() ) {
+        Namespace xmlns = toName(uri);
+        auto classes = XMLObject::factory.find(xmlns);
+        it2 = namespaces.emplace(uri, NamespaceEntry{ xmlns, classes != XMLObject::factory.end() ? &classes->second : nullptr, {} }).first;
+      }
+      it->second = &it2->second;
+    }
+    return *it->second;
+  }
+
+  // Returns the prefix of a qualified name or an empty name if the name has no prefix.
+  const Name& prefixOf(const XMLCh* qname, const XMLCh* localname) {
+    XMLSize_t qnameLength = xercesc::XMLString::stringLen(qname);
+    XMLSize_t localnameLength = xercesc::XMLString::stringLen(localname);
+    // qualified name is "prefix:localname"
+    XMLSize_t prefixLength = ( qnameLength > localnameLength ? qnameLength - localnameLength - 1 : 0 );
+    return nameOf(XMLChStringView(qname, prefixLength));
+  }
+
+  const ElementEntry& lookup(const XMLCh* uri, const XMLCh* localname) {
+    NamespaceEntry& namespaceEntry = namespaceOf(uri);
+
+    auto it2 = namespaceEntry.elements.find(XMLChStringView(localname));
+    if ( it2 == namespaceEntry.elements.end() ) {
+      ElementName elementName = toName(localname);
+      FactoryEntry factoryEntry{ nullptr, &XMLObject::classType };
+      if ( namespaceEntry.classes ) {
+        if ( auto it3 = namespaceEntry.classes->find(elementName); it3 != namespaceEntry.classes->end() ) {
+          factoryEntry = it3->second;
+        }
+      }
+      it2 = namespaceEntry.elements.emplace(localname, ElementEntry{ namespaceEntry.xmlns, elementName, factoryEntry.creator, factoryEntry.type }).first;
+    }
+    return it2->second;
+  }
+
+public:
+  std::pmr::memory_resource* arena = nullptr;
+  TaskPool* taskPool = nullptr;
+  size_t threshold = 0;
+  bool lazy = false;
+  IdIndex* ids = nullptr;
+  std::function<void()> rootCompleted;
+
+  // streaming state
+  bool (*matches)(const TypeId& type) = nullptr;
+  const std::function<void(XMLObject& object)>* callback = nullptr;
+  std::unordered_map<const TypeId*, bool> matchingTypes;
+  size_t skipped = 0; // number of open elements outside of accepted elements
+
+  // Returns the root object and constructs the objects if this was deferred.
+  std::unique_ptr<XMLObject, Deleter> release() {
+    stack.clear();
+    entries.clear();
+    pendingChildren.clear();
+    if ( pendingRoot ) {
+      PendingElement pending = std::move(*pendingRoot);
+      pendingRoot.reset();
+      root = construct(pending);
+    }
+    return std::move(root);
+  }
+
+  // Discards anything left from a previous or failed document.
+  void reset() {
+    stack.clear();
+    entries.clear();
+    pendingChildren.clear();
+    pendingRoot.reset();
+    root.reset();
+  }
+
+  void startDocument() override {
+    reset();
+    // pool ids and their strings are only valid within a document
+    uris.clear();
+  }
+
+  void startElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname, const xercesc::Attributes& elementAttributes) override {
+    const ElementEntry& entry = lookup(uri, localname);
+    if ( matches && stack.empty() ) {
+      auto it = matchingTypes.find(entry.type);
+      if ( it == matchingTypes.end() ) {
+        it = matchingTypes.emplace(entry.type, matches(*entry.type)).first;
+      }
+      if ( !it->second ) {
+        skipped++;
+        return;
+      }
+    }
+
+    if ( !stack.empty() ) {
+      // textual content is only stored for elements without children
+      stack.back().textContent.clear();
+      stack.back().deferredText.clear();
+    }
+
+    entries.push_back(&entry);
+    if ( taskPool && !lazy ) {
+      pendingChildren.emplace_back();
+    }
+    ElementData& element = stack.emplace_back(arena);
+    element.ids = ids;
+    std::pmr::memory_resource* resource = element.resource();
+    element.xmlns = entry.xmlns;
+    element.prefix = prefixOf(qname, localname);
+    element.elementName = entry.elementName;
+
+    // set attributes
+    element.attributes.reserve(elementAttributes.getLength());
+    for (XMLSize_t i = 0; i < elementAttributes.getLength(); i++) {
+      const XMLCh* attributeUri = elementAttributes.getURI(i);
+      // get namespace from atrribute or parent element
+      const Namespace& attributeXmlns = (attributeUri && *attributeUri) ? namespaceOf(attributeUri).xmlns : element.xmlns;
+      const Namespace& attributePrefix = prefixOf(elementAttributes.getQName(i), elementAttributes.getLocalName(i));
+      const AttributeName& attributeName = nameOf(XMLChStringView(elementAttributes.getLocalName(i)));
+      Value attributeValue(transcode(elementAttributes.getValue(i), resource));
+      element.attributes.push_back( { attributeXmlns, attributePrefix, attributeName, std::move(attributeValue) } );
+    }
+  }
+
+  void endElement([[maybe_unused]] const XMLCh* const uri, [[maybe_unused]] const XMLCh* const localname, [[maybe_unused]] const XMLCh* const qname) override {
+    if ( matches && stack.empty() ) {
+      skipped--;
+      return;
+    }
+
+    if ( lazy && stack.size() > 1 ) {
+      // keep the element data in the parent until its children are accessed
+      ElementData& element = stack.back();
+      element.creator = entries.back()->creator;
+      element.type = entries.back()->type;
+      stack[stack.size() - 2].children.defer(std::move(element));
+      stack.pop_back();
+      entries.pop_back();
+      return;
+    }
+
+    if ( taskPool && !lazy ) {
+      // defer construction of the object until the document is parsed
+      PendingElement pending{ std::move(stack.back()), entries.back()->creator, std::move(pendingChildren.back()), 1 };
+      for ( auto& child : pending.children ) {
+        pending.size += child.size;
+      }
+      stack.pop_back();
+      entries.pop_back();
+      pendingChildren.pop_back();
+      if ( stack.empty() ) {
+        pendingRoot.emplace(std::move(pending));
+        if ( rootCompleted ) {
+          rootCompleted();
+        }
+      }
+      else {
+        pendingChildren.back().push_back(std::move(pending));
+      }
+      return;
+    }
+
+    std::unique_ptr<XMLObject, Deleter> object(XMLObject::createObject(entries.back()->creator, stack.back()), Deleter(arena != nullptr));
+    stack.pop_back();
+    entries.pop_back();
+    if ( stack.empty() ) {
+      if ( callback ) {
+        // the object is deleted after the callback returns
+        (*callback)(*object);
+        return;
+      }
+      root = std::move(object);
+      if ( rootCompleted ) {
+        rootCompleted();
+      }
+    }
+    else {
+      stack.back().children.push_back(std::move(object));
+    }
+  }
+
+  void characters(const XMLCh* const chars, const XMLSize_t length) override {
+    if ( !stack.empty() && !hasChildren() ) {
+      if ( lazy && stack.size() > 1 ) {
+        // text is transcoded when the object is created
+        stack.back().deferredText.append(chars, length);
+      }
+      else {
+        appendUTF8(stack.back().textContent, chars, length);
+      }
+    }
+  }
+
+  void fatalError(const xercesc::SAXParseException& exception) override {
+    throw std::runtime_error("Failed to parse XML: " + transcode(exception.getMessage()) + " (line " + std::to_string(exception.getLineNumber()) + ", column " + std::to_string(exception.getColumnNumber()) + ")");
+  }
+};
+
+// Platform initialization and termination must not be called concurrently
+std::mutex platformMutex;
+
+ParserContext::ParserContext() {
+  {
+    std::lock_guard<std::mutex> lock(platformMutex);
+    xercesc::XMLPlatformUtils::Initialize();
+  }
+  handler = std::make_unique<SAX2Handler>();
+  reader.reset(xercesc::XMLReaderFactory::createXMLReader());
+  reader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, true);
+  // report namespace declarations as attributes
+  reader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+  reader->setContentHandler(handler.get());
+  reader->setErrorHandler(handler.get());
 }
 
-Attribute& XMLObject::getRequiredAttributeByName(const AttributeName& attributeName) {
-  auto it = std::find_if(attributes.begin(), attributes.end(),
-                         [attributeName](Attribute& attribute) { return attribute.name == attributeName; }
-  );
-  if (it != attributes.end()) {
-    return *it;
+ParserContext::~ParserContext() {
+  // reader and handler are deleted before calling Terminate
+  reader.reset();
+  handler.reset();
+  std::lock_guard<std::mutex> lock(platformMutex);
+  xercesc::XMLPlatformUtils::Terminate();
+}
+
+void ParserContext::setParallelConstruction(size_t threshold, unsigned int threads) {
+  if ( threads == 0 ) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  handler->taskPool = nullptr;
+  handler->threshold = threshold;
+  taskPool.reset();
+  if ( threshold > 0 ) {
+    taskPool = std::make_unique<TaskPool>(threads);
+    handler->taskPool = taskPool.get();
   }
-  throw std::runtime_error("Failed to get required attribute '" +  attributeName + "' of element '" + elementName + "'");
 }
 
-std::optional< std::reference_wrapper<Attribute> > XMLObject::getOptionalAttributeByName(const AttributeName& attributeName) {
-  auto it = std::find_if(attributes.begin(), attributes.end(),
-                         [attributeName](Attribute& attribute) { return attribute.name == attributeName; }
-  );
-  if (it != attributes.end()) {
-    return *it;
+void ParserContext::setLazyConstruction(bool lazy) {
+  handler->lazy = lazy;
+}
+
+void ParserContext::setIdIndex(IdIndex* ids) {
+  handler->ids = ids;
+}
+
+// Parses the XML using the given parse function and returns the root object created by the handler.
+template<typename ParseFunction>
+XMLObject* parse(SAX2Handler& handler, ParseFunction parseFunction) {
+  try {
+    parseFunction();
   }
-  return std::nullopt;
+  catch (const xercesc::XMLException& exception) {
+    handler.reset();
+    throw std::runtime_error("Failed to parse XML: " + transcode(exception.getMessage()));
+  }
+  catch (...) {
+    handler.reset();
+    throw;
+  }
+
+  std::unique_ptr<XMLObject, Deleter> root = handler.release();
+  if (!root) {
+    throw std::runtime_error("Failed to get root element of XML");
+  }
+  return root.release();
 }
 
-std::string XMLObject::stringify() const {
-  std::string xmlString = std::string("<") + (!prefix.empty() ? prefix + ":" : "") + elementName;
-  for ( auto& attribute : attributes ) {
-    xmlString += std::string(" ") + (!attribute.prefix.empty() ? attribute.prefix + ":" : "") + attribute.name + "=\"" + attribute.value.value +"\"";
+XMLObject* ParserContext::parse(const xercesc::InputSource& inputSource, std::pmr::memory_resource* arena) {
+  handler->arena = arena;
+  return XML::parse(*handler, [this,&inputSource]() { reader->parse(inputSource); });
+}
+
+void ParserContext::forEach(const xercesc::InputSource& inputSource, bool (*matches)(const TypeId& type), const std::function<void(XMLObject& object)>& callback) {
+  // objects are created sequentially and deleted after the callback, thus, neither lazy nor parallel construction is used
+  SAX2Handler streamingHandler;
+  streamingHandler.matches = matches;
+  streamingHandler.callback = &callback;
+
+  // the handler of the context is restored when leaving
+  struct HandlerScope {
+    xercesc::SAX2XMLReader& reader;
+    SAX2Handler& restore;
+    HandlerScope(xercesc::SAX2XMLReader& reader, SAX2Handler& handler, SAX2Handler& restore) : reader(reader), restore(restore) {
+      reader.setContentHandler(&handler);
+      reader.setErrorHandler(&handler);
+    }
+    ~HandlerScope() {
+      reader.setContentHandler(&restore);
+      reader.setErrorHandler(&restore);
+    }
+  } scope(*reader, streamingHandler, *handler);
+
+  try {
+    reader->parse(inputSource);
+  }
+  catch (const xercesc::XMLException& exception) {
+    throw std::runtime_error("Failed to parse XML: " + transcode(exception.getMessage()));
   }
-  xmlString += ">";
+}
 
-  for ( auto& child : children ) {
-    xmlString += child->stringify();
+void ParserContext::forEach(std::istream& xmlStream, bool (*matches)(const TypeId& type), const std::function<void(XMLObject& object)>& callback) {
+  forEach(IStreamInputSource(xmlStream), matches, callback);
+}
+
+XMLObject* ParserContext::parse(const xercesc::InputSource& inputSource) {
+  return parse(inputSource, nullptr);
+}
+
+XMLObject* ParserContext::parse(std::istream& xmlStream) {
+  return parse(IStreamInputSource(xmlStream));
+}
+
+XMLObject* ParserContext::parseString(const std::string& xmlString) {
+  return parseBuffer(xmlString);
+}
+
+XMLObject* ParserContext::parseBuffer(std::string_view xmlBuffer) {
+  // the buffer is neither copied nor adopted by the input source
+  return parse(xercesc::MemBufInputSource((const XMLByte*)xmlBuffer.data(), xmlBuffer.size(), "buffer", false));
+}
+
+XMLObject* ParserContext::parseFile(const std::string& filename) {
+#ifndef WIN32
+  MappedFile file(filename);
+  return parse(xercesc::MemBufInputSource((const XMLByte*)file.view().data(), file.view().size(), filename.c_str(), false));
+#else
+  std::basic_string<XMLCh> path(filename.begin(), filename.end());
+  return parse(xercesc::LocalFileInputSource(path.c_str()));
+#endif
+}
+
+XMLObject& ParserContext::parse(const xercesc::InputSource& inputSource, Document& document) {
+  if ( document.rootObject ) {
+    throw std::runtime_error("Document already contains an XML-tree");
   }
-  xmlString += textContent;
-  xmlString += std::string("</") + (!prefix.empty() ? prefix + ":" : "") + elementName + ">";
-  return xmlString;
+  // objects constructed by concurrent tasks must not allocate from the arena directly
+  document.rootObject = parse(inputSource, taskPool ? &document.synchronizedArena : document.resource());
+  return *document.rootObject;
 }
 
-std::string XMLObject::format(std::string indentation, unsigned int depth) const {
-  // lambda to repeat indentation n times
-  auto indent = [&indentation](unsigned int n) -> std::string {
-    std::string result;
-    for (unsigned int i = 0; i < n; ++i) {
-      result += indentation;
+XMLObject& ParserContext::parse(std::istream& xmlStream, Document& document) {
+  return parse(IStreamInputSource(xmlStream), document);
+}
+
+XMLObject& ParserContext::parseString(const std::string& xmlString, Document& document) {
+  return parseBuffer(xmlString, document);
+}
+
+XMLObject& ParserContext::parseBuffer(std::string_view xmlBuffer, Document& document) {
+  // the buffer is neither copied nor adopted by the input source
+  return parse(xercesc::MemBufInputSource((const XMLByte*)xmlBuffer.data(), xmlBuffer.size(), "buffer", false), document);
+}
+
+XMLObject& ParserContext::parseFile(const std::string& filename, Document& document) {
+#ifndef WIN32
+  MappedFile file(filename);
+  return parse(xercesc::MemBufInputSource((const XMLByte*)file.view().data(), file.view().size(), filename.c_str(), false), document);
+#else
+  std::basic_string<XMLCh> path(filename.begin(), filename.end());
+  return parse(xercesc::LocalFileInputSource(path.c_str()), document);
+#endif
+}
+
+XMLObject* XMLObject::createFromStream(std::istream& xmlStream) {
+  // std::cout << "Create XML object from input stream" << std::endl;
+  return ParserContext().parse(xmlStream);
+}
+
+XMLObject* XMLObject::createFromString(const std::string& xmlString) {
+  // std::cout << "Create XML object from string" << std::endl;
+  return ParserContext().parseString(xmlString);
+}
+
+XMLObject* XMLObject::createFromBuffer(std::string_view xmlBuffer) {
+  return ParserContext().parseBuffer(xmlBuffer);
+}
+
+XMLObject* XMLObject::createFromFile(const std::string& filename) {
+  // std::cout << "Create XML object from file" << std::endl;
+  return ParserContext().parseFile(filename);
+}
+
+// Loads the files using a pool of worker threads each having its own parser context and calls the
+// given function with the index of the file and the result. Calls are serialized by a mutex.
+void loadFiles(const std::vector<std::string>& filenames, unsigned int threads, const std::function<void(size_t index, LoadResult& result)>& completed) {
+  if ( threads == 0 ) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = (unsigned int)std::min<size_t>(threads, filenames.size());
+
+  std::atomic<size_t> next = 0;
+  std::atomic<bool> cancelled = false;
+  std::mutex completedMutex;
+  std::exception_ptr exception;
+
+  auto work = [&]() {
+    try {
+      ParserContext context;
+      for ( size_t index = next++; index < filenames.size() && !cancelled; index = next++ ) {
+        LoadResult result;
+        result.filename = filenames[index];
+        try {
+          result.root.reset(context.parseFile(filenames[index]));
+        }
+        catch (const std::exception& error) {
+          result.error = error.what();
+        }
+
+        std::lock_guard<std::mutex> lock(completedMutex);
+        if ( !cancelled ) {
+          completed(index, result);
+        }
+      }
+    }
+    catch (...) {
+      // the parser context could not be created or the callback failed
+      std::lock_guard<std::mutex> lock(completedMutex);
+      if ( !exception ) {
+        exception = std::current_exception();
+      }
+      cancelled = true;
     }
-    return result;
   };
-  
-  std::string xmlString = indent(depth) + std::string("<") + (!prefix.empty() ? prefix + ":" : "") + elementName;
-  for ( auto& attribute : attributes ) {
-    xmlString += std::string(" ") + (!attribute.prefix.empty() ? attribute.prefix + ":" : "") + attribute.name + "=\"" + attribute.value.value +"\"";
-  }
-  xmlString += ">\n";
 
-  for ( auto& child : children ) {
-    xmlString += child->format(indentation, depth+1);
+  std::vector<std::thread> workers;
+  for ( unsigned int i = 1; i < threads; i++ ) {
+    workers.emplace_back(work);
   }
-  xmlString += textContent;
-  if ( !textContent.empty() && !textContent.ends_with("\n") ) {
-    xmlString += "\n";
-  } 
-  xmlString += indent(depth) + std::string("</") + (!prefix.empty() ? prefix + ":" : "") + elementName + ">\n";
-  return xmlString;
+  // the calling thread is used as a worker, too
+  if ( threads > 0 ) {
+    work();
+  }
+  for ( auto& worker : workers ) {
+    worker.join();
+  }
+
+  if ( exception ) {
+    std::rethrow_exception(exception);
+  }
+}
+
+PushParser::PushParser() : input(std::make_unique<PushInputSource>()) {
+  start(nullptr);
+}
+
+PushParser::PushParser(Document& document) : input(std::make_unique<PushInputSource>()), document(&document) {
+  start(&document);
+}
+
+PushParser::~PushParser() {
+  if ( !finished ) {
+    input->close();
+    worker.join();
+    if ( !document ) {
+      delete root;
+    }
+  }
+}
+
+void PushParser::start(Document* document) {
+  context.handler->rootCompleted = [this]() { complete = true; };
+  worker = std::thread([this,document]() {
+    try {
+      root = document ? &context.parse(*input, *document) : context.parse(*input);
+    }
+    catch (...) {
+      exception = std::current_exception();
+      failed = true;
+    }
+  });
+}
+
+void PushParser::push(std::string_view chunk) {
+  if ( finished ) {
+    throw std::runtime_error("Push parser is already finished");
+  }
+  if ( failed ) {
+    // the exception is set before the flag and not changed afterwards
+    std::rethrow_exception(exception);
+  }
+  input->push(chunk);
+}
+
+XMLObject* PushParser::finish() {
+  if ( finished ) {
+    throw std::runtime_error("Push parser is already finished");
+  }
+  finished = true;
+  input->close();
+  worker.join();
+  if ( exception ) {
+    std::rethrow_exception(exception);
+  }
+  return root;
+}
+
+std::vector<LoadResult> XMLObject::createFromFiles(const std::vector<std::string>& filenames, unsigned int threads) {
+  std::vector<LoadResult> results(filenames.size());
+  loadFiles(filenames, threads, [&results](size_t index, LoadResult& result) { results[index] = std::move(result); });
+  return results;
+}
+
+void XMLObject::createFromFiles(const std::vector<std::string>& filenames, const std::function<void(LoadResult& result)>& callback, unsigned int threads) {
+  loadFiles(filenames, threads, [&callback]([[maybe_unused]] size_t index, LoadResult& result) { callback(result); });
+}
+
+namespace {
+
+// Memory resource counting the bytes allocated from another memory resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+  CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {};
+  size_t allocated() const { return bytes; };
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    void* p = upstream->allocate(bytes, alignment);
+    this->bytes += bytes;
+    return p;
+  };
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    upstream->deallocate(p, bytes, alignment);
+    this->bytes -= bytes;
+  };
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  };
+
+  std::pmr::memory_resource* upstream;
+  std::atomic<size_t> bytes = 0;
+};
+
+// Document kept alive by the shared pointers handed out by the cache
+struct CachedDocument {
+  CountingResource resource{std::pmr::get_default_resource()};
+  Document document{&resource};
+};
+
+} // end anonymous namespace
+
+DocumentCache::DocumentCache(size_t budget) : budget(budget) {
+}
+
+std::shared_ptr<const XMLObject> DocumentCache::get(const std::string& filename) {
+  std::error_code error;
+  auto modified = std::filesystem::last_write_time(filename, error);
+  uintmax_t size = error ? 0 : std::filesystem::file_size(filename, error);
+  if ( error ) {
+    throw std::runtime_error("Failed to open XML-file '" + filename + "'");
+  }
+
+  std::promise< std::shared_ptr<const XMLObject> > promise;
+  uint64_t generation;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = entries.find(filename);
+    if ( it != entries.end() ) {
+      if ( it->second.modified == modified && it->second.size == size ) {
+        statistics.hits++;
+        recent.splice(recent.begin(), recent, it->second.position);
+        auto root = it->second.root;
+        lock.unlock();
+        // waits if the tree is still loaded by another thread
+        return root.get();
+      }
+      statistics.invalidations++;
+      erase(it);
+    }
+    statistics.misses++;
+    generation = ++generations;
+    recent.push_front(filename);
+    entries.emplace(filename, Entry{modified, size, generation, promise.get_future().share(), 0, recent.begin()});
+  }
+
+  std::shared_ptr<const XMLObject> root;
+  size_t bytes;
+  try {
+    auto cached = std::make_shared<CachedDocument>();
+    XMLObject& object = ParserContext().parseFile(filename, cached->document);
+    bytes = cached->resource.allocated();
+    root = std::shared_ptr<const XMLObject>(std::move(cached), &object);
+  }
+  catch (...) {
+    {
+      // failures are not cached
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = entries.find(filename);
+      if ( it != entries.end() && it->second.generation == generation ) {
+        erase(it);
+      }
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(filename);
+    // the entry may have been invalidated or removed while loading
+    if ( it != entries.end() && it->second.generation == generation ) {
+      it->second.bytes = bytes;
+      statistics.bytes += bytes;
+      evict();
+    }
+  }
+  promise.set_value(root);
+  return root;
+}
+
+void DocumentCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  recent.clear();
+  statistics.bytes = 0;
+}
+
+DocumentCache::Statistics DocumentCache::getStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Statistics result = statistics;
+  result.documents = entries.size();
+  return result;
+}
+
+void DocumentCache::erase(std::unordered_map<std::string, Entry>::iterator entry) {
+  statistics.bytes -= entry->second.bytes;
+  recent.erase(entry->second.position);
+  entries.erase(entry);
+}
+
+void DocumentCache::evict() {
+  // trees which are still loaded are skipped as their size is not yet known
+  for ( auto position = recent.end(); statistics.bytes > budget && position != recent.begin(); ) {
+    auto entry = entries.find(*--position);
+    if ( entry->second.bytes > 0 ) {
+      position = std::next(position);
+      statistics.evictions++;
+      erase(entry);
+    }
+  }
+}
+
+Children::Children(Children&& other) noexcept : objects(std::move(other.objects)), pending(std::exchange(other.pending, nullptr)) {
+}
+
+Children& Children::operator=(Children&& other) noexcept {
+  if ( this != &other ) {
+    releasePending();
+    objects = std::move(other.objects);
+    pending = std::exchange(other.pending, nullptr);
+  }
+  return *this;
+}
+
+Children::~Children() {
+  releasePending();
+}
+
+void Children::clear() {
+  objects.clear();
+  releasePending();
+}
+
+const TypeId& Children::typeOf(size_type i) const {
+  if ( objects[i] ) {
+    return objects[i]->objectType;
+  }
+  const ElementData& element = (*pending)[i];
+  return element.type ? *element.type : XMLObject::classType;
+}
+
+const ElementName& Children::nameOf(size_type i) const {
+  if ( objects[i] ) {
+    return objects[i]->elementName;
+  }
+  return (*pending)[i].elementName;
+}
+
+void Children::defer(ElementData&& element) {
+  if ( !pending ) {
+    pending = std::pmr::polymorphic_allocator<>(objects.get_allocator().resource()).new_object< std::pmr::vector<ElementData> >();
+    // the data of each child is kept at the position of the child
+    pending->resize(objects.size());
+  }
+  pending->push_back(std::move(element));
+  objects.emplace_back();
+}
+
+void Children::releasePending() const {
+  if ( pending ) {
+    auto allocator = pending->get_allocator();
+    allocator.delete_object(pending);
+    pending = nullptr;
+  }
+}
+
+void Children::createPending(size_type i) const {
+  ElementData& element = (*pending)[i];
+  appendUTF8(element.textContent, element.deferredText.data(), element.deferredText.size());
+  element.deferredText.clear();
+  objects[i] = value_type(XMLObject::createObject(element.creator, element), Deleter(element.arena != nullptr));
+}
+
+void Children::createPending() const {
+  for ( size_type i = 0; i < objects.size(); i++ ) {
+    if ( !objects[i] ) {
+      // objects created before an exception is thrown are kept
+      createPending(i);
+    }
+  }
+  // release the memory of the element data
+  releasePending();
+}
+
+XMLObject* XMLObject::createObject(ElementData& element) {
+  Creator creator = nullptr;
+  if ( auto it = factory.find(element.xmlns); it != factory.end() ) {
+    if ( auto it2 = it->second.find(element.elementName); it2 != it->second.end() ) {
+      creator = it2->second.creator;
+    }
+  }
+  return createObject(creator, element);
+}
+
+XMLObject* XMLObject::createObject(Creator creator, ElementData& element) {
+  if ( creator ) { 
+    return creator(element.xmlns, element.elementName, element); 
+  }
+  // std::cout << "Unknown element '" << elementName << "' using 'XMLObject' instead" << std::endl;
+  static const ClassName xmlObjectClassName("XMLObject");
+  return createInstance<XMLObject>(element.xmlns, xmlObjectClassName, element);
+}
+
+template<> std::optional<bool> tryParseValue<bool>(std::string_view value) noexcept {
+  if ( value == "true" || value == "1" ) {
+    return true;
+  }
+  if ( value == "false" || value == "0" ) {
+    return false;
+  }
+  return std::nullopt;
+}
+
+// Text and value of the last number of a type parsed by a thread
+template<typename T> struct LastParsed {
+  char text[32];
+  size_t size = 0;
+  T number;
+};
+
+template<typename T> static std::optional<T> tryParseNumber(std::string_view value) noexcept {
+  thread_local LastParsed<T> last;
+  if ( !value.empty() && value.size() == last.size && std::char_traits<char>::compare(value.data(), last.text, value.size()) == 0 ) {
+    return last.number;
+  }
+
+  // leading and trailing whitespace and a plus sign are allowed in XML-schema but not by std::from_chars
+  std::string_view text = value;
+  while ( !text.empty() && std::isspace((unsigned char)text.front()) ) {
+    text.remove_prefix(1);
+  }
+  while ( !text.empty() && std::isspace((unsigned char)text.back()) ) {
+    text.remove_suffix(1);
+  }
+  if ( text.size() > 1 && text.front() == '+' && text[1] != '-' ) {
+    text.remove_prefix(1);
+  }
+  T number = {};
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+  if ( text.empty() || error != std::errc() || end != text.data() + text.size() ) {
+    return std::nullopt;
+  }
+
+  if ( value.size() <= sizeof(last.text) ) {
+    std::char_traits<char>::copy(last.text, value.data(), value.size());
+    last.size = value.size();
+    last.number = number;
+  }
+  return number;
+}
+
+template<> std::optional<int> tryParseValue<int>(std::string_view value) noexcept {
+  return tryParseNumber<int>(value);
+}
+
+template<> std::optional<double> tryParseValue<double>(std::string_view value) noexcept {
+  return tryParseNumber<double>(value);
+}
+
+template<typename T> static T parseOrThrow(std::string_view value, const char* type) {
+  if ( std::optional<T> result = tryParseValue<T>(value) ) {
+    return *result;
+  }
+  throw std::runtime_error("Cannot convert '" + std::string(value) + "' to " + type);
+}
+
+template<> bool parseValue<bool>(std::string_view value) {
+  return parseOrThrow<bool>(value, "bool");
+}
+
+template<> int parseValue<int>(std::string_view value) {
+  return parseOrThrow<int>(value, "int");
+}
+
+template<> double parseValue<double>(std::string_view value) {
+  return parseOrThrow<double>(value, "double");
+}
+
+Value::operator int() const {
+  if ( std::optional<int> number = tryAs<int>() ) {
+    return *number;
+  }
+  // fall back to the conversion of std::stoi, which accepts values with trailing characters
+  char* end = nullptr;
+  errno = 0;
+  long number = std::strtol(value.c_str(), &end, 10);
+  if ( end == value.c_str() || errno == ERANGE || number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max() ) {
+    throw std::runtime_error("Cannot convert '" + std::string(value) + "' to int");
+  }
+  return (int)number;
+}
+
+Value::operator double() const {
+  if ( std::optional<double> number = tryAs<double>() ) {
+    return *number;
+  }
+  // fall back to the conversion of std::stod, which accepts values with trailing characters
+  char* end = nullptr;
+  errno = 0;
+  double number = std::strtod(value.c_str(), &end);
+  if ( end == value.c_str() || errno == ERANGE ) {
+    throw std::runtime_error("Cannot convert '" + std::string(value) + "' to double");
+  }
+  return number;
+}
+
+void XMLObject::addId(ElementData& element, std::string_view id, XMLObject& object) {
+  if ( element.ids ) {
+    element.ids->add(id, object);
+  }
+}
+
+XMLObject::XMLObject(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes)
+  : xmlns(xmlns)
+  , className(className)
+  , prefix(element.prefix)
+  , elementName(element.elementName)
+  , textContent(std::move(element.textContent))
+  , children(std::move(element.children))
+  , attributes(std::move(element.attributes))
+  , defaultAttributes(&defaultAttributes)
+{
+}
+
+
+XMLObject& XMLObject::getRequiredChildByName(const ElementName& elementName) {
+  for ( auto& child : children ) {
+    if ( child->elementName == elementName ) {
+      return *child;
+    }
+  }
+  throw std::runtime_error("Failed to get required child of element '" + std::string(elementName) + "'");
+}
+
+std::optional< std::reference_wrapper<XMLObject> > XMLObject::getOptionalChildByName(const ElementName& elementName) {
+  for ( auto& child : children ) {
+    if ( child->elementName == elementName ) {
+      return *child;
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector< std::reference_wrapper<XMLObject> > XMLObject::getChildrenByName(const ElementName& elementName) {
+  std::vector< std::reference_wrapper<XMLObject> > result;
+  for ( auto& child : children ) {
+    if ( child->elementName == elementName ) {
+      result.push_back(*child);
+    }
+  }
+  return result;
+}
+
+std::pmr::vector< std::reference_wrapper<XMLObject> > XMLObject::getChildrenByName(const ElementName& elementName, std::pmr::memory_resource* resource) {
+  std::pmr::vector< std::reference_wrapper<XMLObject> > result(resource);
+  for ( auto& child : children ) {
+    if ( child->elementName == elementName ) {
+      result.push_back(*child);
+    }
+  }
+  return result;
+}
+
+Attribute& XMLObject::getRequiredAttributeByName(const AttributeName& attributeName) {
+  if ( auto attribute = getOptionalAttributeByName(attributeName) ) {
+    return *attribute;
+  }
+  throw std::runtime_error("Failed to get required attribute '" +  std::string(attributeName) + "' of element '" + std::string(elementName) + "'");
+}
+
+std::optional< std::reference_wrapper<Attribute> > XMLObject::getOptionalAttributeByName(const AttributeName& attributeName) {
+  auto it = std::find_if(attributes.begin(), attributes.end(),
+                         [&attributeName](Attribute& attribute) { return attribute.name == attributeName; }
+  );
+  if (it != attributes.end()) {
+    return *it;
+  }
+  return std::nullopt;
+}
+
+const Attribute& XMLObject::getRequiredAttributeByName(const AttributeName& attributeName) const {
+  if ( auto attribute = getOptionalAttributeByName(attributeName) ) {
+    return *attribute;
+  }
+  throw std::runtime_error("Failed to get required attribute '" +  std::string(attributeName) + "' of element '" + std::string(elementName) + "'");
+}
+
+std::optional< std::reference_wrapper<const Attribute> > XMLObject::getOptionalAttributeByName(const AttributeName& attributeName) const {
+  // look up attributes of the element before falling through to the defaults of the class
+  auto it = std::find_if(attributes.begin(), attributes.end(),
+                         [&attributeName](const Attribute& attribute) { return attribute.name == attributeName; }
+  );
+  if (it != attributes.end()) {
+    return *it;
+  }
+  // defaults of base classes come first, so the defaults are searched from the back for the default of the most-derived class to win
+  auto defaultIt = std::find_if(defaultAttributes->rbegin(), defaultAttributes->rend(),
+                                [&attributeName](const Attribute& attribute) { return attribute.name == attributeName; }
+  );
+  if (defaultIt != defaultAttributes->rend()) {
+    return *defaultIt;
+  }
+  return std::nullopt;
+}
+
+std::string XMLObject::stringify() const {
+  std::string xmlString;
+  Serializer(xmlString).write(*this);
+  return xmlString;
+}
+
+std::string XMLObject::format(std::string indentation, unsigned int depth) const {
+  std::string xmlString;
+  Serializer(xmlString).format(*this, indentation, depth);
+  return xmlString;
+}
+
+namespace {
+
+// Output counting the characters instead of writing them
+struct CountingOutput {
+  size_t size = 0;
+  void write(std::string_view text) { size += text.size(); };
+  void indent(unsigned int depth) { size += depth * indentation.size(); };
+  std::string_view indentation;
+};
+
+// Output writing to a serializer
+struct SerializerOutput {
+  Serializer& serializer;
+  std::string_view indentation;
+  std::string& indentations; // the indentation of each line is a prefix of this string
+  void write(std::string_view text) { serializer.write(text); };
+  void indent(unsigned int depth) {
+    while ( indentations.size() < depth * indentation.size() ) {
+      indentations += indentation;
+    }
+    serializer.write(std::string_view(indentations).substr(0, depth * indentation.size()));
+  };
+};
+
+// Writes the text to the file descriptor
+void writeAll(int fileDescriptor, std::string_view text) {
+  while ( !text.empty() ) {
+#ifndef WIN32
+    auto written = ::write(fileDescriptor, text.data(), text.size());
+    if ( written < 0 && errno == EINTR ) {
+      continue;
+    }
+#else
+    auto written = _write(fileDescriptor, text.data(), (unsigned int)text.size());
+#endif
+    if ( written < 0 ) {
+      throw std::runtime_error("Failed to write to file descriptor " + std::to_string(fileDescriptor));
+    }
+    text.remove_prefix((size_t)written);
+  }
+}
+
+template<typename Output> void writeName(Output& output, const Namespace& prefix, const Name& name) {
+  if ( !prefix.empty() ) {
+    output.write(prefix.view());
+    output.write(":");
+  }
+  output.write(name.view());
+}
+
+template<typename Output> void writeAttribute(Output& output, const Attribute& attribute) {
+  output.write(" ");
+  writeName(output, attribute.prefix, attribute.name);
+  output.write("=\"");
+  output.write(attribute.value.value);
+  output.write("\"");
+}
+
+// Returns whether the i-th default attribute applies to the object, i.e., it is neither given by the
+// element nor overridden by a default of a derived class, which come after the defaults of base classes
+bool isDefaultUsed(const XMLObject& object, size_t i) {
+  const Attributes& defaults = *object.defaultAttributes;
+  auto named = [&defaults, i](const Attribute& attribute) { return attribute.name == defaults[i].name; };
+  return std::none_of(object.attributes.begin(), object.attributes.end(), named)
+    && std::none_of(defaults.begin() + (std::ptrdiff_t)i + 1, defaults.end(), named);
+}
+
+// Writes the start tag, the children, the textual content and the end tag of each element. The
+// children are visited using a stack instead of recursion, so that deep trees can be written.
+template<bool Formatted, typename Output> void serialize(const XMLObject& root, unsigned int depth, bool defaultAttributes, Output& output) {
+  struct Element {
+    const XMLObject* object;
+    Children::const_iterator next;
+  };
+  std::vector<Element> stack;
+
+  auto open = [&](const XMLObject& object) {
+    if constexpr ( Formatted ) {
+      output.indent(depth + (unsigned int)stack.size());
+    }
+    output.write("<");
+    writeName(output, object.prefix, object.elementName);
+    for ( auto& attribute : object.attributes ) {
+      writeAttribute(output, attribute);
+    }
+    if ( defaultAttributes ) {
+      // default attributes not given by the element follow the attributes of the element
+      for ( size_t i = 0; i < object.defaultAttributes->size(); i++ ) {
+        if ( isDefaultUsed(object, i) ) {
+          writeAttribute(output, (*object.defaultAttributes)[i]);
+        }
+      }
+    }
+    output.write(Formatted ? ">\n" : ">");
+    stack.push_back({&object, object.children.begin()});
+  };
+
+  open(root);
+  while ( !stack.empty() ) {
+    Element& element = stack.back();
+    if ( element.next != element.object->children.end() ) {
+      open(**element.next++);
+      continue;
+    }
+    const XMLObject& object = *element.object;
+    stack.pop_back();
+    output.write(object.textContent);
+    if constexpr ( Formatted ) {
+      if ( !object.textContent.empty() && !object.textContent.ends_with("\n") ) {
+        output.write("\n");
+      }
+      output.indent(depth + (unsigned int)stack.size());
+    }
+    output.write("</");
+    writeName(output, object.prefix, object.elementName);
+    output.write(Formatted ? ">\n" : ">");
+  }
+}
+
+} // end anonymous namespace
+
+Serializer::~Serializer() {
+  try {
+    flush();
+  }
+  catch (...) {
+  }
+}
+
+Serializer& Serializer::write(const XMLObject& object) {
+  SerializerOutput output{*this, {}, indentations};
+  serialize<false>(object, 0, defaultAttributes, output);
+  return *this;
+}
+
+Serializer& Serializer::format(const XMLObject& object, std::string_view indentation, unsigned int depth) {
+  if ( indentation != indentationUnit ) {
+    // the cached indentations are only valid for the indentation they are repeated from
+    indentations.clear();
+    indentationUnit = indentation;
+  }
+  SerializerOutput output{*this, indentation, indentations};
+  serialize<true>(object, depth, defaultAttributes, output);
+  return *this;
+}
+
+Serializer& Serializer::write(std::string_view text) {
+  if ( target ) {
+    target->append(text);
+  }
+  else if ( stream ) {
+    stream->write(text.data(), (std::streamsize)text.size());
+  }
+  else if ( buffer.size() + text.size() <= bufferSize ) {
+    buffer.append(text);
+  }
+  else {
+    flush();
+    if ( text.size() < bufferSize ) {
+      buffer.append(text);
+    }
+    else {
+      writeAll(fileDescriptor, text);
+    }
+  }
+  return *this;
+}
+
+void Serializer::flush() {
+  try {
+    writeAll(fileDescriptor, buffer);
+  }
+  catch (...) {
+    // the output is discarded so that it is not written again
+    buffer.clear();
+    throw;
+  }
+  buffer.clear();
+}
+
+size_t Serializer::size(const XMLObject& object, bool defaultAttributes) {
+  CountingOutput output;
+  serialize<false>(object, 0, defaultAttributes, output);
+  return output.size;
+}
+
+size_t Serializer::formattedSize(const XMLObject& object, std::string_view indentation, unsigned int depth, bool defaultAttributes) {
+  CountingOutput output{0, indentation};
+  serialize<true>(object, depth, defaultAttributes, output);
+  return output.size;
+}
+
+Query::Query(std::string_view path) {
+  size_t position = 0;
+  auto fail = [&path](const std::string& reason) {
+    throw std::runtime_error("Invalid query '" + std::string(path) + "': " + reason);
+  };
+  auto skipWhitespace = [&]() {
+    while ( position < path.size() && std::isspace((unsigned char)path[position]) ) {
+      position++;
+    }
+  };
+  auto accept = [&](std::string_view token) {
+    skipWhitespace();
+    if ( path.substr(position, token.size()) == token ) {
+      position += token.size();
+      return true;
+    }
+    return false;
+  };
+  // reads a name and removes its namespace prefix
+  auto readName = [&]() {
+    skipWhitespace();
+    size_t start = position;
+    while ( position < path.size() && ( std::isalnum((unsigned char)path[position]) || path[position] == '_' || path[position] == '-' || path[position] == '.' || path[position] == ':' || (unsigned char)path[position] >= 0x80 ) ) {
+      position++;
+    }
+    if ( start == position ) {
+      fail("name expected at position " + std::to_string(start));
+    }
+    std::string_view name = path.substr(start, position - start);
+    return name.substr(name.find(':') == std::string_view::npos ? 0 : name.find(':') + 1);
+  };
+
+  Axis axis = Axis::Child;
+  if ( accept("//") ) {
+    axis = Axis::DescendantOrSelf;
+  }
+  else if ( accept("/") ) {
+    axis = Axis::Self;
+  }
+
+  while ( true ) {
+    Step& step = steps.emplace_back(Step{ axis, std::nullopt, {}, {} });
+
+    if ( accept("*") ) {
+      // any element
+    }
+    else if ( accept("type(") ) {
+      ClassName className = readName();
+      auto [begin, end] = XMLObject::classTypes.equal_range(className);
+      for ( auto it = begin; it != end; it++ ) {
+        step.types.push_back(*it->second);
+      }
+      if ( step.types.empty() ) {
+        fail("unknown class '" + std::string(className) + "'");
+      }
+      if ( !accept(")") ) {
+        fail("')' expected at position " + std::to_string(position));
+      }
+    }
+    else {
+      step.elementName = readName();
+    }
+
+    while ( accept("[") ) {
+      if ( !accept("@") ) {
+        fail("'@' expected at position " + std::to_string(position));
+      }
+      Predicate& predicate = step.predicates.emplace_back(Predicate{ readName(), std::nullopt, false });
+      predicate.negated = accept("!=");
+      if ( predicate.negated || accept("=") ) {
+        skipWhitespace();
+        char quote = position < path.size() ? path[position] : 0;
+        size_t end = ( quote == '\'' || quote == '"' ) ? path.find(quote, position + 1) : std::string_view::npos;
+        if ( end == std::string_view::npos ) {
+          fail("quoted value expected at position " + std::to_string(position));
+        }
+        predicate.value = std::string(path.substr(position + 1, end - position - 1));
+        position = end + 1;
+      }
+      if ( !accept("]") ) {
+        fail("']' expected at position " + std::to_string(position));
+      }
+    }
+
+    if ( accept("//") ) {
+      axis = Axis::Descendant;
+    }
+    else if ( accept("/") ) {
+      axis = Axis::Child;
+    }
+    else {
+      break;
+    }
+  }
+
+  skipWhitespace();
+  if ( position != path.size() ) {
+    fail("unexpected character at position " + std::to_string(position));
+  }
+
+  // an object can only be reached along several paths if a descendant step follows a step which can select nested objects
+  bool nested = false;
+  for ( auto& step : steps ) {
+    if ( step.axis == Axis::Descendant && nested ) {
+      mayRepeat = true;
+    }
+    nested = nested || step.axis == Axis::Descendant || step.axis == Axis::DescendantOrSelf;
+  }
+}
+
+bool Query::matches(const Step& step, XMLObject& object) const {
+  if ( step.elementName && object.elementName != *step.elementName ) {
+    return false;
+  }
+  if ( !step.types.empty() ) {
+    bool derived = false;
+    for ( auto& type : step.types ) {
+      if ( object.objectType.isDerivedFrom(type) ) {
+        derived = true;
+        break;
+      }
+    }
+    if ( !derived ) {
+      return false;
+    }
+  }
+  for ( auto& predicate : step.predicates ) {
+    // the const overload also finds the default attributes of the class
+    auto attribute = std::as_const(object).getOptionalAttributeByName(predicate.name);
+    bool satisfied = attribute && ( !predicate.value || std::string_view(attribute->get().value.value) == *predicate.value );
+    if ( satisfied == predicate.negated ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Continues with the next step if the candidate is selected by the step with the given index.
+// Returns false if the evaluation is stopped by the visitor.
+bool Query::select(size_t index, XMLObject& candidate, const std::function<bool(XMLObject& object)>& visit) const {
+  if ( !matches(steps[index], candidate) ) {
+    return true;
+  }
+  return index + 1 == steps.size() ? visit(candidate) : evaluate(index + 1, candidate, visit);
+}
+
+// Applies the step with the given index to all descendants of the object in document order.
+bool Query::descend(size_t index, XMLObject& object, const std::function<bool(XMLObject& object)>& visit) const {
+  for ( auto& child : object.children ) {
+    if ( !select(index, *child, visit) || !descend(index, *child, visit) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Applies the step with the given index to the object.
+bool Query::evaluate(size_t index, XMLObject& object, const std::function<bool(XMLObject& object)>& visit) const {
+  switch ( steps[index].axis ) {
+    case Axis::Self:
+      return select(index, object, visit);
+    case Axis::Child:
+      for ( auto& child : object.children ) {
+        if ( !select(index, *child, visit) ) {
+          return false;
+        }
+      }
+      return true;
+    case Axis::DescendantOrSelf:
+      return select(index, object, visit) && descend(index, object, visit);
+    case Axis::Descendant:
+      return descend(index, object, visit);
+  }
+  return true;
+}
+
+bool Query::evaluate(XMLObject& context, const std::function<bool(XMLObject& object)>& visit) const {
+  if ( !mayRepeat ) {
+    return evaluate(0, context, visit);
+  }
+  std::unordered_set<const XMLObject*> visited;
+  return evaluate(0, context, [&visited,&visit](XMLObject& object) {
+    return visited.insert(&object).second ? visit(object) : true;
+  });
+}
+
+void Query::forEach(XMLObject& context, const std::function<void(XMLObject& object)>& callback) const {
+  evaluate(context, [&callback](XMLObject& object) { callback(object); return true; });
+}
+
+XMLObject* Query::first(XMLObject& context) const {
+  XMLObject* result = nullptr;
+  evaluate(context, [&result](XMLObject& object) { result = &object; return false; });
+  return result;
+}
+
+std::vector<std::reference_wrapper<XMLObject>> Query::select(XMLObject& context) const {
+  std::vector<std::reference_wrapper<XMLObject>> result;
+  evaluate(context, [&result](XMLObject& object) { result.push_back(object); return true; });
+  return result;
+}
+
+size_t Query::count(XMLObject& context) const {
+  size_t result = 0;
+  evaluate(context, [&result](XMLObject&) { result++; return true; });
+  return result;
+}
+
+FrozenDocument XMLObject::freeze() const {
+  return FrozenDocument(*this);
+}
+
+// Collects the arrays of a frozen document while the XML-tree is traversed.
+struct FrozenDocument::Builder {
+  // arrays owned by the frozen document
+  struct Arrays {
+    std::vector<uint32_t> elements;
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> ends;
+    std::vector<uint32_t> elementNames;
+    std::vector<uint32_t> attributeOffsets;
+    std::vector<StringRange> textContents;
+    std::vector<uint32_t> attributeNames;
+    std::vector<StringRange> attributeValues;
+    std::string strings;
+  };
+  std::shared_ptr<Arrays> arrays = std::make_shared<Arrays>();
+  std::vector<ElementClass> classes;
+  std::vector<const Attributes*> classDefaults; // default attributes of each class
+  std::vector<Name> names;
+  std::unordered_map<const void*, uint32_t> namePositions;
+  std::unordered_map<const void*, std::vector<uint32_t>> classPositions; // positions of the classes by class name
+
+  uint32_t position(const Name& name) {
+    auto [it, inserted] = namePositions.try_emplace(name.id(), (uint32_t)names.size());
+    if ( inserted ) {
+      names.push_back(name);
+    }
+    return it->second;
+  };
+
+  StringRange store(std::string_view value) {
+    if ( arrays->strings.size() + value.size() > std::numeric_limits<uint32_t>::max() ) {
+      throw std::runtime_error("XML-tree is too large to be frozen");
+    }
+    StringRange range = { (uint32_t)arrays->strings.size(), (uint32_t)value.size() };
+    arrays->strings += value;
+    return range;
+  };
+
+  void addAttribute(const Attribute& attribute) {
+    if ( arrays->attributeNames.size() >= std::numeric_limits<uint32_t>::max() ) {
+      throw std::runtime_error("XML-tree is too large to be frozen");
+    }
+    arrays->attributeNames.push_back(position(attribute.name));
+    arrays->attributeValues.push_back(store(attribute.value.value));
+  };
+
+  uint32_t add(const XMLObject& object, uint32_t parent) {
+    if ( arrays->elements.size() >= std::numeric_limits<uint32_t>::max() ) {
+      throw std::runtime_error("XML-tree is too large to be frozen");
+    }
+    uint32_t index = (uint32_t)arrays->elements.size();
+
+    auto& positions = classPositions[object.className.id()];
+    auto it = std::find_if(positions.begin(), positions.end(), [this, &object](uint32_t position) {
+      const ElementClass& elementClass = classes[position];
+      return names[elementClass.xmlns] == object.xmlns && names[elementClass.prefix] == object.prefix && classDefaults[position] == object.defaultAttributes
+        && elementClass.type.hierarchy == object.objectType.hierarchy && elementClass.type.first == object.objectType.first;
+    });
+    if ( it == positions.end() ) {
+      positions.push_back((uint32_t)classes.size());
+      classes.push_back({ position(object.className), position(object.xmlns), position(object.prefix), 0, 0, object.objectType });
+      classDefaults.push_back(object.defaultAttributes);
+      it = positions.end() - 1;
+    }
+
+    arrays->elements.push_back(*it);
+    arrays->parents.push_back(parent);
+    arrays->ends.push_back(index + 1);
+    arrays->elementNames.push_back(position(object.elementName));
+    arrays->attributeOffsets.push_back((uint32_t)arrays->attributeNames.size());
+    for ( auto& attribute : object.attributes ) {
+      addAttribute(attribute);
+    }
+    arrays->textContents.push_back(store(object.textContent));
+    return index;
+  };
+};
+
+FrozenDocument::FrozenDocument(const XMLObject& root) {
+  Builder builder;
+  // objects of which not all children are added yet and the position of the next child
+  struct Pending {
+    const XMLObject* object;
+    uint32_t index;
+    size_t child;
+  };
+  std::vector<Pending> pending = { { &root, builder.add(root, 0), 0 } };
+  while ( !pending.empty() ) {
+    Pending& current = pending.back();
+    if ( current.child < current.object->children.size() ) {
+      const XMLObject& child = *current.object->children[current.child++];
+      uint32_t parent = current.index;
+      pending.push_back({ &child, builder.add(child, parent), 0 });
+    }
+    else {
+      builder.arrays->ends[current.index] = (uint32_t)builder.arrays->elements.size();
+      pending.pop_back();
+    }
+  }
+  builder.arrays->attributeOffsets.push_back((uint32_t)builder.arrays->attributeNames.size());
+
+  // the default attributes of each class are stored once after the attributes of all elements
+  for ( size_t i = 0; i < builder.classes.size(); i++ ) {
+    builder.classes[i].defaultsOffset = (uint32_t)builder.arrays->attributeNames.size();
+    if ( builder.classDefaults[i] ) {
+      for ( auto& attribute : *builder.classDefaults[i] ) {
+        builder.addAttribute(attribute);
+      }
+    }
+    builder.classes[i].defaultsCount = (uint32_t)builder.arrays->attributeNames.size() - builder.classes[i].defaultsOffset;
+  }
+
+  auto& arrays = *builder.arrays;
+  classes = std::move(builder.classes);
+  names = std::move(builder.names);
+  elements = arrays.elements;
+  parents = arrays.parents;
+  ends = arrays.ends;
+  elementNames = arrays.elementNames;
+  attributeOffsets = arrays.attributeOffsets;
+  textContents = arrays.textContents;
+  attributeNames = arrays.attributeNames;
+  attributeValues = arrays.attributeValues;
+  strings = arrays.strings;
+  storage = std::move(builder.arrays);
+}
+
+/*
+ * A snapshot consists of a header followed by the sections listed in SnapshotLayout, each starting
+ * at a multiple of eight bytes. The names are stored in the string pool after the attribute
+ * values and textual contents.
+ */
+namespace {
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t classCount;
+  uint32_t nameCount;
+  uint32_t elementCount;
+  uint32_t attributeCount; // number of attributes of all elements and default attributes of all classes
+  uint64_t stringsSize;
+  uint64_t schemaFingerprint; // fingerprint of all generated classes of the process writing the snapshot
+};
+
+struct SnapshotClass {
+  uint32_t className;
+  uint32_t xmlns;
+  uint32_t prefix;
+  uint32_t defaultsOffset;
+  uint32_t defaultsCount;
+  uint32_t reserved;
+  uint64_t fingerprint; ///< Fingerprint of the generated class or 0 if the class is not generated
+};
+
+constexpr char snapshotMagic[8] = { 'X', 'M', 'L', 'F', 'R', 'O', 'Z', 'N' };
+constexpr uint32_t snapshotVersion = 2;
+constexpr uint32_t snapshotByteOrder = 0x01020304;
+
+// Offsets of the sections of a snapshot
+struct SnapshotLayout {
+  size_t classes, names, elements, parents, ends, elementNames, attributeOffsets, textContents, attributeNames, attributeValues, strings, size;
+
+  SnapshotLayout(const SnapshotHeader& header) {
+    size_t offset = 0;
+    auto section = [&offset](size_t bytes) {
+      size_t start = ( offset + 7 ) / 8 * 8;
+      offset = start + bytes;
+      return start;
+    };
+    section(sizeof(SnapshotHeader));
+    classes = section((size_t)header.classCount * sizeof(SnapshotClass));
+    names = section((size_t)header.nameCount * 2 * sizeof(uint32_t));
+    elements = section((size_t)header.elementCount * sizeof(uint32_t));
+    parents = section((size_t)header.elementCount * sizeof(uint32_t));
+    ends = section((size_t)header.elementCount * sizeof(uint32_t));
+    elementNames = section((size_t)header.elementCount * sizeof(uint32_t));
+    attributeOffsets = section(((size_t)header.elementCount + 1) * sizeof(uint32_t));
+    textContents = section((size_t)header.elementCount * 2 * sizeof(uint32_t));
+    attributeNames = section((size_t)header.attributeCount * sizeof(uint32_t));
+    attributeValues = section((size_t)header.attributeCount * 2 * sizeof(uint32_t));
+    strings = section(header.stringsSize);
+    size = offset;
+  };
+};
+
+} // end anonymous namespace
+
+uint64_t FrozenDocument::schemaFingerprint() {
+  uint64_t fingerprint = 0;
+  for ( auto& [type, classFingerprint] : XMLObject::classFingerprints ) {
+    // the mixed fingerprints of the classes are added, such that the order of the classes does not matter
+    fingerprint += ( classFingerprint * 0x9E3779B97F4A7C15ULL ) ^ ( classFingerprint >> 29 );
+  }
+  return fingerprint;
+}
+
+void FrozenDocument::writeSnapshot(const std::string& filename) const {
+  std::string pool(strings);
+  std::vector<StringRange> nameRanges;
+  for ( auto& name : names ) {
+    nameRanges.push_back({ (uint32_t)pool.size(), (uint32_t)name.size() });
+    pool += name;
+  }
+  if ( pool.size() > std::numeric_limits<uint32_t>::max() ) {
+    throw std::runtime_error("Document is too large for a snapshot");
+  }
+
+  std::vector<SnapshotClass> snapshotClasses;
+  for ( auto& elementClass : classes ) {
+    uint64_t fingerprint = 0;
+    if ( elementClass.type.hierarchy && elementClass.type.hierarchy != XMLObject::classType.hierarchy ) {
+      auto [begin, end] = XMLObject::classTypes.equal_range(names[elementClass.className]);
+      auto it = std::find_if(begin, end, [&elementClass](auto& entry) { return entry.second->hierarchy == elementClass.type.hierarchy && entry.second->first == elementClass.type.first; });
+      if ( it == end || !XMLObject::classFingerprints.count(it->second) ) {
+        throw std::runtime_error("Failed to get fingerprint of class '" + std::string(names[elementClass.className]) + "'");
+      }
+      fingerprint = XMLObject::classFingerprints.at(it->second);
+    }
+    snapshotClasses.push_back({ elementClass.className, elementClass.xmlns, elementClass.prefix, elementClass.defaultsOffset, elementClass.defaultsCount, 0, fingerprint });
+  }
+
+  SnapshotHeader header = {};
+  std::copy(std::begin(snapshotMagic), std::end(snapshotMagic), header.magic);
+  header.version = snapshotVersion;
+  header.byteOrder = snapshotByteOrder;
+  header.classCount = (uint32_t)classes.size();
+  header.nameCount = (uint32_t)names.size();
+  header.elementCount = (uint32_t)elements.size();
+  header.attributeCount = (uint32_t)attributeNames.size();
+  header.stringsSize = pool.size();
+  header.schemaFingerprint = schemaFingerprint();
+  SnapshotLayout layout(header);
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if ( !file ) {
+    throw std::runtime_error("Failed to open snapshot '" + filename + "' for writing");
+  }
+  auto write = [&file](size_t offset, const void* data, size_t bytes) {
+    static const char padding[8] = {};
+    file.write(padding, offset - (size_t)file.tellp());
+    file.write((const char*)data, bytes);
+  };
+  write(0, &header, sizeof(header));
+  write(layout.classes, snapshotClasses.data(), snapshotClasses.size() * sizeof(SnapshotClass));
+  write(layout.names, nameRanges.data(), nameRanges.size() * sizeof(StringRange));
+  write(layout.elements, elements.data(), elements.size_bytes());
+  write(layout.parents, parents.data(), parents.size_bytes());
+  write(layout.ends, ends.data(), ends.size_bytes());
+  write(layout.elementNames, elementNames.data(), elementNames.size_bytes());
+  write(layout.attributeOffsets, attributeOffsets.data(), attributeOffsets.size_bytes());
+  write(layout.textContents, textContents.data(), textContents.size_bytes());
+  write(layout.attributeNames, attributeNames.data(), attributeNames.size_bytes());
+  write(layout.attributeValues, attributeValues.data(), attributeValues.size_bytes());
+  write(layout.strings, pool.data(), pool.size());
+  if ( !file.flush() ) {
+    throw std::runtime_error("Failed to write snapshot '" + filename + "'");
+  }
+}
+
+FrozenDocument FrozenDocument::mapSnapshot(const std::string& filename) {
+  FrozenDocument document;
+  size_t size = 0;
+#ifndef WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  if ( fd < 0 ) {
+    throw std::runtime_error("Failed to open snapshot '" + filename + "'");
+  }
+  struct stat status;
+  void* data = MAP_FAILED;
+  if ( fstat(fd, &status) == 0 && status.st_size > 0 ) {
+    size = (size_t)status.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if ( data == MAP_FAILED ) {
+    throw std::runtime_error("Failed to map snapshot '" + filename + "'");
+  }
+  document.storage = std::shared_ptr<const void>(data, [size](const void* data) { munmap(const_cast<void*>(data), size); });
+#else
+  std::ifstream file(filename, std::ios::binary);
+  if ( !file ) {
+    throw std::runtime_error("Failed to open snapshot '" + filename + "'");
+  }
+  auto content = std::make_shared<std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  size = content->size();
+  document.storage = std::shared_ptr<const void>(content, content->data());
+#endif
+  const char* base = (const char*)document.storage.get();
+
+  SnapshotHeader header;
+  if ( size < sizeof(header) ) {
+    throw std::runtime_error("Invalid snapshot '" + filename + "'");
+  }
+  std::memcpy(&header, base, sizeof(header));
+  if ( !std::equal(std::begin(snapshotMagic), std::end(snapshotMagic), header.magic) || header.version != snapshotVersion || header.byteOrder != snapshotByteOrder || header.elementCount == 0 ) {
+    throw std::runtime_error("Invalid snapshot '" + filename + "'");
+  }
+  SnapshotLayout layout(header);
+  if ( layout.size > size ) {
+    throw std::runtime_error("Invalid snapshot '" + filename + "'");
+  }
+  if ( header.schemaFingerprint != schemaFingerprint() ) {
+    // the type ids of all classes may differ, even of classes not used in the snapshot
+    throw std::runtime_error("Snapshot '" + filename + "' does not match the generated classes");
+  }
+
+  auto array = [base](size_t offset, size_t count) { return std::span<const uint32_t>((const uint32_t*)(base + offset), count); };
+  auto ranges = [base](size_t offset, size_t count) { return std::span<const StringRange>((const StringRange*)(base + offset), count); };
+  document.elements = array(layout.elements, header.elementCount);
+  document.parents = array(layout.parents, header.elementCount);
+  document.ends = array(layout.ends, header.elementCount);
+  document.elementNames = array(layout.elementNames, header.elementCount);
+  document.attributeOffsets = array(layout.attributeOffsets, header.elementCount + 1);
+  document.textContents = ranges(layout.textContents, header.elementCount);
+  document.attributeNames = array(layout.attributeNames, header.attributeCount);
+  document.attributeValues = ranges(layout.attributeValues, header.attributeCount);
+  document.strings = std::string_view(base + layout.strings, header.stringsSize);
+
+  // only the names and classes are read, the arrays of the elements are used in place
+  for ( auto range : ranges(layout.names, header.nameCount) ) {
+    if ( (size_t)range.offset + range.size > header.stringsSize ) {
+      throw std::runtime_error("Invalid snapshot '" + filename + "'");
+    }
+    document.names.emplace_back(document.get(range));
+  }
+  const SnapshotClass* snapshotClasses = (const SnapshotClass*)(base + layout.classes);
+  for ( uint32_t i = 0; i < header.classCount; i++ ) {
+    const SnapshotClass& snapshotClass = snapshotClasses[i];
+    if ( snapshotClass.className >= header.nameCount || snapshotClass.xmlns >= header.nameCount || snapshotClass.prefix >= header.nameCount
+         || (size_t)snapshotClass.defaultsOffset + snapshotClass.defaultsCount > header.attributeCount ) {
+      throw std::runtime_error("Invalid snapshot '" + filename + "'");
+    }
+    TypeId type = XMLObject::classType;
+    if ( snapshotClass.fingerprint ) {
+      const ClassName& className = document.names[snapshotClass.className];
+      auto [begin, end] = XMLObject::classTypes.equal_range(className);
+      auto it = std::find_if(begin, end, [&snapshotClass](auto& entry) {
+        auto fingerprint = XMLObject::classFingerprints.find(entry.second);
+        return fingerprint != XMLObject::classFingerprints.end() && fingerprint->second == snapshotClass.fingerprint;
+      });
+      if ( it == end ) {
+        throw std::runtime_error("Snapshot '" + filename + "' does not match the generated class '" + std::string(className) + "'");
+      }
+      type = *it->second;
+    }
+    document.classes.push_back({ snapshotClass.className, snapshotClass.xmlns, snapshotClass.prefix, snapshotClass.defaultsOffset, snapshotClass.defaultsCount, type });
+  }
+
+  // the arrays are used in place without checks, thus all indices and ranges are validated once
+  auto inStrings = [&header](const StringRange& range) { return (size_t)range.offset + range.size <= header.stringsSize; };
+  for ( uint32_t i = 0; i < header.elementCount; i++ ) {
+    // the subtree of each element ends within the subtree of its parent, which precedes the element
+    if ( document.elements[i] >= header.classCount || document.elementNames[i] >= header.nameCount
+         || document.ends[i] <= i || document.ends[i] > header.elementCount
+         || ( i > 0 && ( document.parents[i] >= i || document.ends[i] > document.ends[document.parents[i]] ) )
+         || document.attributeOffsets[i] > document.attributeOffsets[i + 1]
+         || !inStrings(document.textContents[i]) ) {
+      throw std::runtime_error("Invalid snapshot '" + filename + "'");
+    }
+  }
+  if ( document.attributeOffsets[header.elementCount] > header.attributeCount ) {
+    throw std::runtime_error("Invalid snapshot '" + filename + "'");
+  }
+  for ( uint32_t i = 0; i < header.attributeCount; i++ ) {
+    if ( document.attributeNames[i] >= header.nameCount || !inStrings(document.attributeValues[i]) ) {
+      throw std::runtime_error("Invalid snapshot '" + filename + "'");
+    }
+  }
+  return document;
+}
+
+std::optional< Frozen<XMLObject> > Frozen<XMLObject>::parent() const {
+  if ( index == 0 ) {
+    return std::nullopt;
+  }
+  return Frozen<XMLObject>(*document, document->parents[index]);
+}
+
+std::optional<std::string_view> Frozen<XMLObject>::getOptionalAttributeByName(const AttributeName& attributeName) const {
+  // look up attributes of the element before falling through to the defaults of the class
+  for ( uint32_t i = document->attributeOffsets[index]; i < document->attributeOffsets[index + 1]; i++ ) {
+    if ( document->names[document->attributeNames[i]] == attributeName ) {
+      return document->get(document->attributeValues[i]);
+    }
+  }
+  // defaults of base classes come first, so the default of the most-derived class is the last one found
+  for ( uint32_t i = elementClass().defaultsOffset + elementClass().defaultsCount; i > elementClass().defaultsOffset; i-- ) {
+    if ( document->names[document->attributeNames[i - 1]] == attributeName ) {
+      return document->get(document->attributeValues[i - 1]);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string_view Frozen<XMLObject>::getRequiredAttributeByName(const AttributeName& attributeName) const {
+  if ( auto value = getOptionalAttributeByName(attributeName) ) {
+    return *value;
+  }
+  throw std::runtime_error("Failed to get required attribute '" +  std::string(attributeName) + "' of element '" + std::string(elementName()) + "'");
+}
+
+std::optional< Frozen<XMLObject> > Frozen<XMLObject>::getOptionalChildByName(const ElementName& elementName) const {
+  auto children = childrenNamed(elementName);
+  if ( children.empty() ) {
+    return std::nullopt;
+  }
+  return children.front();
+}
+
+Frozen<XMLObject> Frozen<XMLObject>::getRequiredChildByName(const ElementName& elementName) const {
+  if ( auto child = getOptionalChildByName(elementName) ) {
+    return *child;
+  }
+  throw std::runtime_error("Failed to get required child of element '" + std::string(this->elementName()) + "'");
 }
 
 std::ostream& operator<< (std::ostream& os, const XMLObject* obj) {
-  os << obj->stringify();
+  Serializer(os).write(*obj);
   return os;
 }
 
 std::ostream& operator<< (std::ostream& os, const XMLObject& obj) {
-  os << obj.stringify();
+  Serializer(os).write(obj);
   return os;
 }
 
@@ -1,14 +1,29 @@
 #ifndef XMLObject_H
 #define XMLObject_H
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <optional>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <charconv>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <filesystem>
+#include <future>
+#include <list>
 
-#include <xercesc/dom/DOM.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
 
 /**
  * @brief The `XML` namespace contains classes representing XML-nodes defined in given XML-schema(s). 
@@ -16,19 +31,104 @@
 namespace XML {
 
 class XMLObject;
+class SAX2Handler;
+class Document;
+struct ElementData;
+struct TypeId;
+class TaskPool;
+class PushInputSource;
+class IdIndex;
+template<typename T, bool Recursive> class ObjectRange;
+class FrozenDocument;
 
-typedef std::string ClassName;
-typedef std::string ElementName;
-typedef std::string TextContent;
-typedef std::string Namespace;
-typedef std::string AttributeName;
+/**
+ * @brief A class representing an interned and immutable name.
+ *
+ * All names with the same content share the same storage in a process-wide symbol table.
+ * Thus, names are compared by pointer and copying a name does not copy its content.
+ * A name can be used like a `std::string_view`.
+ */
+class Name {
+public:
+  Name() : name(intern({})) {};
+  Name(std::string_view value) : name(intern(value)) {};
+  Name(const char* value) : name(intern(value)) {};
+  Name(const std::string& value) : name(intern(value)) {};
+
+  operator std::string_view() const { return *name; };
+  std::string_view view() const { return *name; };
+  const char* data() const { return name->data(); };
+  size_t size() const { return name->size(); };
+  bool empty() const { return name->empty(); };
+
+  bool operator==(const Name& other) const { return name == other.name; };
+  bool operator==(std::string_view other) const { return *name == other; };
+  bool operator==(const char* other) const { return *name == other; };
+  bool operator==(const std::string& other) const { return *name == other; };
+
+  /// @brief Returns the address of the interned name, which is unique for each name.
+  const void* id() const { return name; };
+
+private:
+  const std::string* name;
+  static const std::string* intern(std::string_view value);
+};
+
+/// @brief Allows printing of names
+inline std::ostream& operator<<(std::ostream& os, const Name& name) { return os << name.view(); }
+
+} // end namespace XML
+
+/// @brief Allows names to be used as keys of unordered containers
+template<> struct std::hash<XML::Name> {
+  size_t operator()(const XML::Name& name) const noexcept { return std::hash<const void*>()(name.id()); }
+};
+
+namespace XML {
+
+typedef Name ClassName;
+typedef Name ElementName;
+typedef std::pmr::string TextContent;
+typedef Name Namespace;
+typedef Name AttributeName;
+
+/**
+ * @brief Parses a value of an attribute as `bool`, `int`, or `double` without throwing.
+ *
+ * Numbers are parsed with `std::from_chars`, booleans are `true` or `1` and `false` or `0`.
+ * The last number parsed by a thread is cached, i.e., parsing the same text again does not
+ * require to convert it again.
+ *
+ * @return The converted value, or `std::nullopt` if the value cannot be converted.
+ */
+template<typename T> std::optional<T> tryParseValue(std::string_view value) noexcept;
+template<> std::optional<bool> tryParseValue<bool>(std::string_view value) noexcept;
+template<> std::optional<int> tryParseValue<int>(std::string_view value) noexcept;
+template<> std::optional<double> tryParseValue<double>(std::string_view value) noexcept;
+
+/**
+ * @brief Parses a value of an attribute as `bool`, `int`, or `double`.
+ *
+ * @throws std::runtime_error if the value cannot be converted.
+ * @see tryParseValue()
+ */
+template<typename T> T parseValue(std::string_view value);
+template<> bool parseValue<bool>(std::string_view value);
+template<> int parseValue<int>(std::string_view value);
+template<> double parseValue<double>(std::string_view value);
 
 /**
  * @brief A struct representing the value of an XML-node attribute.
  *
  * The Value struct stores a value and provides implicit conversion and assignment operators
  * to facilitate easy conversion between different types and convenient assignment
- * of values.
+ * of values. Numbers are converted with `std::from_chars` and `std::to_chars`, i.e.,
+ * conversions do not allocate memory and doubles are written with the shortest
+ * representation that is read back as the same value. The implicit conversions to `int`
+ * and `double` accept the same values as `std::stoi` and `std::stod`, i.e., they convert
+ * the leading number of values such as `"12px"`, whereas `as<T>()` and `tryAs<T>()`
+ * require the entire value to be a number. All conversions to `bool` accept `"true"`
+ * and `"1"` as true, the implicit conversion returns false for any other value.
  *
  * Example usage:
  * ```
@@ -42,23 +142,31 @@ typedef std::string AttributeName;
  * bool booleanValue = value;           // Implicit conversion to bool.
  * int integerValue = value;            // Implicit conversion to int.
  * double realValue = value;            // Implicit conversion to double.
+ *
+ * double checked = value.as<double>(); // Conversion throwing std::runtime_error on failure.
+ * std::optional<int> number = value.tryAs<int>(); // Conversion without exceptions.
  * ```
  */
 struct Value {
-  std::string value;
+  std::pmr::string value;
   operator std::string_view() const { return value; };
-  operator std::string() const { return value; };
-  operator bool() const { return (value == True); };
-  operator int() const { try { return std::stoi(value); } catch(...) { throw std::runtime_error("Cannot convert '" + value + "' to int"); } };
-  operator double() const { try { return std::stod(value); } catch(...) { throw std::runtime_error("Cannot convert '" + value + "' to double"); } };
+  operator std::string() const { return std::string(value); };
+  operator bool() const { return tryAs<bool>().value_or(false); };
+  operator int() const;
+  operator double() const;
+  /// @brief Returns the value converted to `bool`, `int`, or `double`, or `std::nullopt` if it cannot be converted.
+  template<typename T> std::optional<T> tryAs() const noexcept { return tryParseValue<T>(value); };
+  /// @brief Returns the value converted to `bool`, `int`, or `double` and throws `std::runtime_error` if it cannot be converted.
+  template<typename T> T as() const { return parseValue<T>(value); };
   Value& operator=(const std::string& s) { value = s; return *this; };
   Value& operator=(bool b) { value = (b ? True : False); return *this; };
-  Value& operator=(int i) { value = std::to_string(i); return *this; };
-  Value& operator=(double d) { value = std::to_string(d); return *this; };
+  Value& operator=(int i) { char buffer[16]; value.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), i).ptr); return *this; };
+  Value& operator=(double d) { char buffer[32]; value.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), d).ptr); return *this; };
   Value(const std::string& s) : value(s) {};
+  Value(std::pmr::string s) : value(std::move(s)) {};
   Value(bool b) : value(b ? True : False) {};
-  Value(int i) : value(std::to_string(i)) {};
-  Value(double d) : value(std::to_string(d)) {};
+  Value(int i) { *this = i; };
+  Value(double d) { *this = d; };
   inline static std::string True = "true";
   inline static std::string False = "false";
 };
@@ -76,15 +184,191 @@ struct Attribute {
   Value value;
 };
 
-typedef std::vector<Attribute> Attributes;
-typedef std::vector<std::unique_ptr<XMLObject>> Children;
+/**
+ * @brief Deleter used for children of an XMLObject.
+ *
+ * Objects allocated on the heap are deleted. Objects allocated in the arena of a @ref Document are
+ * only destroyed, their memory is released together with the document.
+ */
+struct Deleter {
+  bool arena = false;
+  Deleter() = default;
+  Deleter(bool arena) : arena(arena) {};
+  Deleter(std::default_delete<XMLObject>) {};
+  void operator()(XMLObject* object) const;
+};
+
+typedef std::pmr::vector<Attribute> Attributes;
+
+/// @brief Function creating an instance of a class
+typedef XMLObject* (*Creator)(const Namespace& xmlns, const ClassName& className, ElementData& element);
+
+/**
+ * @brief Container of the child elements of an XMLObject.
+ *
+ * The container can be used like a `std::pmr::vector` of owning pointers. If the XML-tree is
+ * created in lazy mode (see @ref ParserContext::setLazyConstruction()), the objects of the children
+ * are only created when the container is accessed for the first time. @ref object() only creates the
+ * object of the requested child and @ref size(), @ref isCreated(), @ref typeOf(), and @ref nameOf()
+ * create no objects.
+ * This is not thread-safe, @ref materialize() can be used to create the objects before sharing the
+ * XML-tree among threads.
+ */
+class Children {
+public:
+  typedef std::unique_ptr<XMLObject, Deleter> value_type;
+  typedef std::pmr::vector<value_type> Objects;
+  typedef Objects::allocator_type allocator_type;
+  typedef Objects::size_type size_type;
+  typedef Objects::reference reference;
+  typedef Objects::const_reference const_reference;
+  typedef Objects::iterator iterator;
+  typedef Objects::const_iterator const_iterator;
+  typedef Objects::reverse_iterator reverse_iterator;
+  typedef Objects::const_reverse_iterator const_reverse_iterator;
+
+  Children(const allocator_type& allocator = {}) : objects(allocator) {};
+  Children(Children&& other) noexcept;
+  Children& operator=(Children&& other) noexcept;
+  ~Children();
+
+  iterator begin() { materialize(); return objects.begin(); };
+  iterator end() { materialize(); return objects.end(); };
+  const_iterator begin() const { materialize(); return objects.begin(); };
+  const_iterator end() const { materialize(); return objects.end(); };
+  const_iterator cbegin() const { return begin(); };
+  const_iterator cend() const { return end(); };
+  reverse_iterator rbegin() { materialize(); return objects.rbegin(); };
+  reverse_iterator rend() { materialize(); return objects.rend(); };
+  const_reverse_iterator rbegin() const { materialize(); return objects.rbegin(); };
+  const_reverse_iterator rend() const { materialize(); return objects.rend(); };
+
+  size_type size() const { return objects.size(); };
+  bool empty() const { return objects.empty(); };
+  reference operator[](size_type i) { materialize(); return objects[i]; };
+  const_reference operator[](size_type i) const { materialize(); return objects[i]; };
+  reference at(size_type i) { materialize(); return objects.at(i); };
+  const_reference at(size_type i) const { materialize(); return objects.at(i); };
+  reference front() { materialize(); return objects.front(); };
+  const_reference front() const { materialize(); return objects.front(); };
+  reference back() { materialize(); return objects.back(); };
+  const_reference back() const { materialize(); return objects.back(); };
+
+  void reserve(size_type capacity) { objects.reserve(capacity); };
+  void push_back(value_type&& child) { materialize(); objects.push_back(std::move(child)); };
+  iterator insert(const_iterator position, value_type&& child) { materialize(); return objects.insert(position, std::move(child)); };
+  iterator erase(const_iterator position) { materialize(); return objects.erase(position); };
+  iterator erase(const_iterator first, const_iterator last) { materialize(); return objects.erase(first, last); };
+  void clear();
+
+  allocator_type get_allocator() const { return objects.get_allocator(); };
+
+  /// @brief Returns the object of the i-th child. If the objects of the children are not yet created, only this object is created.
+  XMLObject& object(size_type i) const {
+    if ( !objects[i] ) {
+      createPending(i);
+    }
+    return *objects[i];
+  };
+
+  /// @brief Returns whether the object of the i-th child is already created.
+  bool isCreated(size_type i) const { return objects[i] != nullptr; };
+
+  /// @brief Returns the type id of the class of the i-th child without creating the object of the child.
+  const TypeId& typeOf(size_type i) const;
+  /// @brief Returns the element name of the i-th child without creating the object of the child.
+  const ElementName& nameOf(size_type i) const;
+
+  /// @brief Creates the objects of all children which are not yet created.
+  void materialize() const {
+    if ( pending ) {
+      createPending();
+    }
+  };
+
+private:
+  friend class SAX2Handler;
+  void createPending() const;
+  void createPending(size_type i) const;
+  // Keeps the data of a child of which the object is created on first access
+  void defer(ElementData&& element);
+  void releasePending() const;
+
+  mutable Objects objects; // null for children of which the objects are not yet created
+  // data of the children at their positions until all objects are created, only allocated if there are children which are not yet created
+  mutable std::pmr::vector<ElementData>* pending = nullptr;
+};
+
+/**
+ * @brief A struct holding the data of an XML-element collected by the parser.
+ *
+ * The parser collects the namespace, prefix, name, attributes, children, and textual content
+ * of an element while reading the XML. Once the element is closed, the respective object is
+ * created and takes over the collected data. If an arena is given, all data is allocated
+ * from the arena, otherwise the default memory resource is used.
+ */
+struct ElementData {
+  ElementData(std::pmr::memory_resource* arena = nullptr)
+    : arena(arena)
+    , attributes(resource())
+    , children(resource())
+    , textContent(resource())
+    , deferredText(resource())
+  {};
+  std::pmr::memory_resource* arena;
+  Namespace xmlns;
+  Namespace prefix;
+  ElementName elementName;
+  Attributes attributes;
+  Children children;
+  TextContent textContent;
+  Creator creator = nullptr; ///< Creator of the object, only used if the object is created lazily
+  const TypeId* type = nullptr; ///< Type id of the class of the object, only used if the object is created lazily
+  IdIndex* ids = nullptr; ///< Index to which the objects of generated classes add their IDs, if any
+  std::basic_string<XMLCh, std::char_traits<XMLCh>, std::pmr::polymorphic_allocator<XMLCh>> deferredText; ///< Untranscoded text, only used if the object is created lazily
+  std::pmr::memory_resource* resource() const { return arena ? arena : std::pmr::get_default_resource(); };
+};
+
+/**
+ * @brief Position of a class in a hierarchy of generated classes.
+ *
+ * schematic++ numbers the classes of each class hierarchy in depth-first order. A class is derived
+ * from another class of the same hierarchy if and only if its number lies within the interval
+ * `[first, last]` of the other class.
+ */
+struct TypeId {
+  const void* hierarchy; ///< Identifies the hierarchy, i.e., the root class
+  uint32_t first; ///< Depth-first number of the class
+  uint32_t last; ///< Largest depth-first number of all classes derived from the class
+  /// @brief Returns true if the class is the given class or a class derived from it.
+  constexpr bool isDerivedFrom(const TypeId& base) const { return hierarchy == base.hierarchy && base.first <= first && first <= base.last; };
+};
+
+/// @brief Type id of class T, allowing to determine whether a class declares its own type id
+template<typename T> struct ClassType : TypeId {};
+
+/// @brief Checks whether class T declares its own type id
+template<typename T, typename = void> struct HasClassType : std::false_type {};
+template<typename T> struct HasClassType<T, std::enable_if_t<std::is_same_v<std::remove_cv_t<decltype(T::classType)>, ClassType<T>>>> : std::true_type {};
 
 /// @brief Template function used to store in factory
-template<typename T> XMLObject* createInstance(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element) { return new T(xmlns, className, element, T::defaults); }
+template<typename T> XMLObject* createInstance(const Namespace& xmlns, const ClassName& className, ElementData& element);
+
+/// @brief Entry of the factory providing the creator and the type id of a generated class
+struct FactoryEntry {
+  Creator creator;
+  const TypeId* type;
+};
 
-/// @brief Factory used to create instance depending on element name
-typedef std::unordered_map<ElementName, XMLObject* (*)(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element)> Factory;
+/// @brief Factory used to create instance depending on namespace and element name
+typedef std::unordered_map<Namespace, std::unordered_map<ElementName, FactoryEntry>> Factory;
 
+/// @brief Outcome of loading one of several XML-files
+struct LoadResult {
+  std::string filename; ///< The path to the XML file
+  std::unique_ptr<XMLObject> root; ///< The created XMLObject or nullptr if loading failed
+  std::string error; ///< The reason why loading failed
+};
 
 /**
  * @brief A class representing a node in an XML-tree.
@@ -92,8 +376,12 @@ typedef std::unordered_map<ElementName, XMLObject* (*)(const Namespace& xmlns, c
  * The XMLObject class allows to read and store an XML-tree. The root element can be created using
  * - @ref XMLObject::createFromStream(std::istream& xmlStream)
  * - @ref XMLObject::createFromString(const std::string& xmlString)
+ * - @ref XMLObject::createFromBuffer(std::string_view xmlBuffer)
  * - @ref XMLObject::createFromFile(const std::string& filename)
  *
+ * Many XML-files can be loaded concurrently using @ref XMLObject::createFromFiles(). Large XML-files
+ * can be processed element by element using @ref XMLObject::forEach().
+ *
  * Each object has the following members:
  * - @ref xmlns : refers to the XML namespace
  * - @ref className : refers to the class it belong to
@@ -110,6 +398,9 @@ typedef std::unordered_map<ElementName, XMLObject* (*)(const Namespace& xmlns, c
  * Each XMLObject can be converted to a string using @ref stringify() and printed to an output stream
  * using @ref operator<<(std::ostream& os, const XMLObject* obj) and
  * @ref operator<<(std::ostream& os, const XMLObject& obj) .
+ *
+ * To parse many documents, use a @ref ParserContext which avoids the setup and teardown of the
+ * parser for each document.
  */
 class XMLObject {
 
@@ -132,34 +423,142 @@ public:
    */
 	static XMLObject* createFromString(const std::string& xmlString);
 
+  /**
+   * @brief Create an XMLObject from a buffer containing XML.
+   *
+   * The buffer is read in place and must remain valid until the function returns.
+   *
+   * @param xmlBuffer The buffer containing the XML data.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+	static XMLObject* createFromBuffer(std::string_view xmlBuffer);
+
   /**
    * @brief Create an XMLObject from an XML file.
    *
+   * The file is mapped into memory and read in place.
+   *
    * @param filename The path to the XML file.
    * @return A pointer to the created XMLObject.
    * @throws std::runtime_error if loading the file or parsing the XML fails.
    */
 	static XMLObject* createFromFile(const std::string& filename);
 
+  /**
+   * @brief Create XMLObjects from many XML files using a pool of worker threads.
+   *
+   * Each worker uses its own @ref ParserContext. Failing to load a file does not affect
+   * the other files.
+   *
+   * @param filenames The paths to the XML files.
+   * @param threads The number of worker threads, if 0 the number of hardware threads is used.
+   * @return The result for each file in the order of the filenames.
+   */
+	static std::vector<LoadResult> createFromFiles(const std::vector<std::string>& filenames, unsigned int threads = 0);
+
+  /**
+   * @brief Create XMLObjects from many XML files and pass each result to a callback as soon as it is completed.
+   *
+   * The callback is invoked from the worker threads, but never concurrently. It may take ownership
+   * of the created XMLObject. If the callback throws, no further files are loaded and the exception
+   * is rethrown after all workers are finished.
+   *
+   * @param filenames The paths to the XML files.
+   * @param callback The function called for each completed file.
+   * @param threads The number of worker threads, if 0 the number of hardware threads is used.
+   */
+	static void createFromFiles(const std::vector<std::string>& filenames, const std::function<void(LoadResult& result)>& callback, unsigned int threads = 0);
+
+  /**
+   * @brief Visit each element of type T in the input stream without creating the entire XML-tree.
+   *
+   * See @ref ParserContext::forEach().
+   *
+   * @param xmlStream The input stream containing the XML data.
+   * @param callback The function called for each element of type T.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  template<typename T>
+  static void forEach(std::istream& xmlStream, const std::function<void(T& object)>& callback);
+
   virtual ~XMLObject() {};
 
 protected:
-  static XMLObject* createObject(const xercesc::DOMElement* element);
+  static XMLObject* createObject(ElementData& element);
+  static XMLObject* createObject(Creator creator, ElementData& element);
 
-template<typename T> friend XMLObject* createInstance(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element);
+template<typename T> friend XMLObject* createInstance(const Namespace& xmlns, const ClassName& className, ElementData& element);
+friend class SAX2Handler;
+friend class Children;
+friend class Query;
+friend class FrozenDocument;
 
 protected:
-  XMLObject(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element, const Attributes& defaultAttributes);
+  XMLObject(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes);
+
 
   inline static Factory factory;
+
+  /// @brief Type ids of all generated classes by class name, used to resolve type tests of queries
+  inline static std::unordered_multimap<ClassName, const TypeId*> classTypes;
+
+  /// @brief Fingerprints of the definitions of all generated classes by type id, used to reject snapshots of outdated classes
+  inline static std::unordered_map<const TypeId*, uint64_t> classFingerprints;
+
+  /// @brief Adds the object to the ID index of the element data, if any. Used by generated classes for attributes of type `xsd:ID`.
+  static void addId(ElementData& element, std::string_view id, XMLObject& object);
+
+  /// @brief Returns the memory resource from which the object's data is allocated.
+  std::pmr::memory_resource* memoryResource() const { return children.get_allocator().resource(); }
+
+private:
+  // type id of the class of the object, if the class does not declare its own type id dynamic_cast is used
+  TypeId objectType = {};
+
+  template<typename T> inline bool isDerivedFrom() const {
+    typedef std::remove_cv_t<T> Class;
+    if constexpr ( std::is_same_v<Class, XMLObject> ) {
+      return true;
+    }
+    else if constexpr ( HasClassType<Class>::value ) {
+      if ( objectType.hierarchy ) {
+        return objectType.isDerivedFrom(Class::classType);
+      }
+    }
+    return dynamic_cast<const Class*>(this) != nullptr;
+  }
+
 public:
-  /// @brief Returns a pointer of type T of the object.
+  /// @brief Identifies the hierarchy of generated classes, which is hidden by the root class of each hierarchy
+  static constexpr char typeHierarchy = 0;
+  /// @brief Type id of objects of elements which are not generated
+  static constexpr ClassType<XMLObject> classType = {{ &typeHierarchy, 0, 0 }};
+
+  /**
+   * @brief Returns a pointer of type T of the object.
+   *
+   * For generated classes, the type is checked using the type ids of the classes, otherwise
+   * dynamic_cast is used.
+   *
+   * @return A pointer to the object or `nullptr` if the object is not of type T.
+   */
   template<typename T> inline T* is() {
-    return dynamic_cast<T*>(this);
+    if constexpr ( !std::is_base_of_v<XMLObject, std::remove_cv_t<T>> ) {
+      return dynamic_cast<T*>(this);
+    }
+    else {
+      return isDerivedFrom<T>() ? static_cast<T*>(this) : nullptr;
+    }
   }
 
   template<typename T> inline const T* is() const {
-    return dynamic_cast<const T*>(this);
+    if constexpr ( !std::is_base_of_v<XMLObject, std::remove_cv_t<T>> ) {
+      return dynamic_cast<const T*>(this);
+    }
+    else {
+      return isDerivedFrom<T>() ? static_cast<const T*>(this) : nullptr;
+    }
   }
 
   /**
@@ -168,7 +567,7 @@ public:
    * @throws std::runtime_error if the cast fails.
    */
   template<typename T> inline T* get() {
-    T* ptr = dynamic_cast<T*>(this);
+    T* ptr = is<T>();
     if ( ptr == nullptr ) {
       throw std::runtime_error("XMLObject: Illegal cast");
     }
@@ -181,37 +580,13 @@ public:
    * @throws std::runtime_error if the cast fails.
    */
   template<typename T> inline const T* get() const {
-    const T* ptr = dynamic_cast<const T*>(this);
+    const T* ptr = is<T>();
     if ( ptr == nullptr ) {
       throw std::runtime_error("XMLObject: Illegal cast");
     }
     return ptr;
   }
 
-private:
-  template<typename T>
-  void findRecursive(std::vector<std::reference_wrapper<T> >& result, const Children& descendants)
-  {
-    for (auto& descendant : descendants) {
-      if (descendant->is<T>()) {
-        result.push_back(*descendant->get<T>());
-      }
-      findRecursive(result, descendant->children );
-    }
-  }
-
-  template<typename T>
-  void findRecursive(std::vector<std::reference_wrapper<const T> >& result, const Children& descendants) const
-  {
-    for (auto& descendant : descendants) {
-      if (descendant->is<const T>()) {
-        result.push_back(*descendant->get<const T>());
-      }
-      findRecursive(result, descendant->children );
-    }
-  }
-
-public:
   /**
    * @brief Find all descendants of type T.
    *
@@ -221,7 +596,9 @@ public:
   std::vector<std::reference_wrapper<T> > find()
   {
     std::vector<std::reference_wrapper<T> > result;
-    findRecursive(result, children);
+    for ( T& object : descendants<T>() ) {
+      result.push_back(object);
+    }
     return result;
   }
 
@@ -234,10 +611,23 @@ public:
   std::vector<std::reference_wrapper<const T> > find() const
   {
     std::vector<std::reference_wrapper<const T> > result;
-    findRecursive(result, children);
+    for ( const T& object : descendants<T>() ) {
+      result.push_back(object);
+    }
     return result;
   }
 
+  /**
+   * @brief Get a view of all descendants of type T in document order.
+   *
+   * Unlike @ref find(), the view does not allocate memory for the result and the XML-tree is only
+   * traversed while the view is iterated over, i.e., the traversal can be stopped at any time.
+   *
+   * @return A view of references to descendants of type T.
+   */
+  template<typename T> ObjectRange<T, true> descendants() { return ObjectRange<T, true>(children); }
+  template<typename T> ObjectRange<const T, true> descendants() const { return ObjectRange<const T, true>(children); }
+
   Namespace xmlns;
   const ClassName className;
   Namespace prefix;
@@ -247,10 +637,13 @@ public:
   Children children; ///< Child nodes of the XML element
   Attributes attributes; /// Attributes of the XML element
 	inline static const Attributes defaults = {};
+  const Attributes* defaultAttributes; ///< Default attributes of the class, shared by all of its objects and not copied into `attributes`
 
   /**
    * @brief Convert the XMLObject and its children to a string representation.
    *
+   * To write the XMLObject without creating a string, see @ref Serializer.
+   *
    * @return The string representation of the XMLObject.
    */
   std::string stringify() const;
@@ -262,6 +655,13 @@ public:
    */
   std::string format(std::string indentation = "\t", unsigned int depth = 0) const;
 
+  /**
+   * @brief Creates an immutable compact copy of the XMLObject and its descendants.
+   *
+   * @return The frozen document, see @ref FrozenDocument.
+   */
+  FrozenDocument freeze() const;
+
   /**
    * @brief Get a required child of type T.
    *
@@ -270,11 +670,11 @@ public:
    */
   template<typename T> T& getRequiredChild() {
     for ( auto& child : children ) {
-      if ( child->is<T>() ) {
-        return *child->get<T>();
+      if ( T* object = child->is<T>() ) {
+        return *object;
       }
     }
-    throw std::runtime_error("Failed to get required child of element '" + elementName + "'");
+    throw std::runtime_error("Failed to get required child of element '" + std::string(elementName) + "'");
   }
 
   /**
@@ -285,8 +685,8 @@ public:
    */
   template<typename T> std::optional< std::reference_wrapper<T> > getOptionalChild() {
     for ( auto& child : children ) {
-      if ( child->is<T>() ) {
-        return *child->get<T>();
+      if ( T* object = child->is<T>() ) {
+        return *object;
       }
     }
     return std::nullopt;
@@ -300,8 +700,24 @@ public:
   template<typename T> std::vector< std::reference_wrapper<T> > getChildren() {
     std::vector< std::reference_wrapper<T> > result;
     for ( auto& child : children ) {
-      if ( child->is<T>() ) {
-        result.push_back(*child->get<T>());
+      if ( T* object = child->is<T>() ) {
+        result.push_back(*object);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Get all children of type T.
+   *
+   * @param resource The memory resource used for the result.
+   * @return A vector of references to the children of type T.
+   */
+  template<typename T> std::pmr::vector< std::reference_wrapper<T> > getChildren(std::pmr::memory_resource* resource) {
+    std::pmr::vector< std::reference_wrapper<T> > result(resource);
+    for ( auto& child : children ) {
+      if ( T* object = child->is<T>() ) {
+        result.push_back(*object);
       }
     }
     return result;
@@ -334,7 +750,39 @@ public:
   std::vector< std::reference_wrapper<XMLObject> > getChildrenByName(const ElementName& elementName);
 
   /**
-   * @brief Get a required attribute with the specified attribute name.
+   * @brief Get all children with the specified element name.
+   *
+   * @param elementName The name of the child elements without namespace prefix.
+   * @param resource The memory resource used for the result.
+   * @return A vector of references to the children with the specified element name.
+   */
+  std::pmr::vector< std::reference_wrapper<XMLObject> > getChildrenByName(const ElementName& elementName, std::pmr::memory_resource* resource);
+
+  /**
+   * @brief Get a view of all children of type T.
+   *
+   * Unlike @ref getChildren(), the view does not allocate memory for the result and the children
+   * are only checked while the view is iterated over.
+   *
+   * @return A view of references to the children of type T.
+   */
+  template<typename T> ObjectRange<T, false> childrenOfType() { return ObjectRange<T, false>(children); }
+  template<typename T> ObjectRange<const T, false> childrenOfType() const { return ObjectRange<const T, false>(children); }
+
+  /**
+   * @brief Get a view of all children with the specified element name.
+   *
+   * @param elementName The name of the child elements without namespace prefix.
+   * @return A view of references to the children with the specified element name.
+   */
+  ObjectRange<XMLObject, false> childrenNamed(const ElementName& elementName);
+  ObjectRange<const XMLObject, false> childrenNamed(const ElementName& elementName) const;
+
+  /**
+   * @brief Get a required attribute of the element with the specified attribute name.
+   *
+   * Only the attributes of the element are searched, the shared default attributes of the class
+   * cannot be changed and are only returned by the const overload.
    *
    * @param attributeName The name of the attribute without namespace prefix.
    * @return A reference to the required attribute.
@@ -343,7 +791,21 @@ public:
   Attribute& getRequiredAttributeByName(const AttributeName& attributeName);
 
   /**
-   * @brief Get an optional attribute with the specified attribute name.
+   * @brief Get a required attribute with the specified attribute name.
+   *
+   * If the element has no such attribute, the default attribute of the class is returned.
+   *
+   * @param attributeName The name of the attribute without namespace prefix.
+   * @return A reference to the required attribute.
+   * @throws std::runtime_error if the required attribute is not found.
+   */
+  const Attribute& getRequiredAttributeByName(const AttributeName& attributeName) const;
+
+  /**
+   * @brief Get an optional attribute of the element with the specified attribute name.
+   *
+   * Only the attributes of the element are searched, the shared default attributes of the class
+   * cannot be changed and are only returned by the const overload.
    *
    * @param attributeName The name of the attribute without namespace prefix.
    * @return An optional containing a reference to the optional attribute if found,
@@ -351,14 +813,1189 @@ public:
    */
   std::optional< std::reference_wrapper<Attribute> > getOptionalAttributeByName(const AttributeName& attributeName);
 
+  /**
+   * @brief Get an optional attribute with the specified attribute name.
+   *
+   * If the element has no such attribute, the default attribute of the class is returned. If
+   * a derived class overrides the default of a base class, the default of the derived class is returned.
+   *
+   * @param attributeName The name of the attribute without namespace prefix.
+   * @return An optional containing a reference to the optional attribute if found,
+   *         or `std::nullopt` if the optional attribute is not found.
+   */
+  std::optional< std::reference_wrapper<const Attribute> > getOptionalAttributeByName(const AttributeName& attributeName) const;
+
 
 };
 
-/// @brief  Allows printing of stringified XML object
-std::ostream& operator<<(std::ostream& os, const XMLObject* obj);
-/// @brief  Allows printing of stringified XML object
-std::ostream& operator<<(std::ostream& os, const XMLObject& obj);
+inline void Deleter::operator()(XMLObject* object) const {
+  if ( arena ) {
+    object->~XMLObject();
+  }
+  else {
+    delete object;
+  }
+}
 
-} // end namespace XML
+/**
+ * @brief Forward iterator over the children or descendants of an XMLObject of type T.
+ *
+ * Descendants are visited in document order without recursion. The positions of the iterator
+ * within the children of the ancestors of the current object are kept in the iterator itself,
+ * memory is only allocated for objects nested more than `inlineDepth` levels deep. Iterators over
+ * children only keep a single position.
+ */
+template<typename T, bool Recursive>
+class ObjectIterator {
+public:
+  typedef std::remove_cv_t<T> value_type;
+  typedef T& reference;
+  typedef T* pointer;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::forward_iterator_tag iterator_category;
+
+  /// @brief Number of nesting levels for which no memory is allocated, small as range adaptors copy iterators
+  static constexpr size_t inlineDepth = Recursive ? 8 : 1;
+
+  ObjectIterator() = default;
+  ObjectIterator(const Children& children, const std::optional<ElementName>& elementName) : elementName(elementName) {
+    push(children);
+    settle();
+  };
+
+  reference operator*() const { return *object; };
+  pointer operator->() const { return object; };
+  ObjectIterator& operator++() { advance(); settle(); return *this; };
+  ObjectIterator operator++(int) { ObjectIterator previous = *this; ++*this; return previous; };
+  bool operator==(const ObjectIterator& other) const { return object == other.object; };
+  bool operator==(std::default_sentinel_t) const { return object == nullptr; };
+
+private:
+  struct Position {
+    const Children::value_type* current;
+    const Children::value_type* end;
+  };
+
+  T* object = nullptr;
+  std::optional<ElementName> elementName;
+  size_t depth = 0;
+  Position positions[inlineDepth] = {};
+  std::vector<Position> deepPositions; // positions beyond inlineDepth
+
+  Position& top() { return depth > inlineDepth ? deepPositions.back() : positions[depth - 1]; };
+
+  void push(const Children& children) {
+    Position position = { std::to_address(children.begin()), std::to_address(children.end()) };
+    if ( depth < inlineDepth ) {
+      positions[depth] = position;
+    }
+    else {
+      deepPositions.push_back(position);
+    }
+    depth++;
+  };
+
+  void pop() {
+    depth--;
+    if ( depth >= inlineDepth ) {
+      deepPositions.pop_back();
+    }
+  };
+
+  // moves to the first child of the current candidate if there is one, otherwise to its next sibling
+  void advance() {
+    Position& position = top();
+    if constexpr ( Recursive ) {
+      if ( !(*position.current)->children.empty() ) {
+        push((*position.current)->children);
+        return;
+      }
+    }
+    position.current++;
+  };
+
+  // moves to the next candidate selected by the iterator unless the current candidate is selected
+  void settle() {
+    while ( depth ) {
+      Position& position = top();
+      if ( position.current == position.end ) {
+        pop();
+        if ( depth ) {
+          top().current++;
+        }
+        continue;
+      }
+      XMLObject& candidate = **position.current;
+      if ( ( !elementName || candidate.elementName == *elementName ) && ( object = candidate.is<T>() ) ) {
+        return;
+      }
+      advance();
+    }
+    object = nullptr;
+  };
+};
+
+/**
+ * @brief View of the children or descendants of an XMLObject of type T.
+ *
+ * The view refers to the children of the object and can be combined with the range adaptors of
+ * the standard library, e.g., `std::views::filter` or `std::views::take`.
+ */
+template<typename T, bool Recursive>
+class ObjectRange : public std::ranges::view_interface< ObjectRange<T, Recursive> > {
+public:
+  ObjectRange() = default;
+  ObjectRange(const Children& children, std::optional<ElementName> elementName = std::nullopt) : children(&children), elementName(elementName) {};
+
+  ObjectIterator<T, Recursive> begin() const { return children ? ObjectIterator<T, Recursive>(*children, elementName) : ObjectIterator<T, Recursive>(); };
+  std::default_sentinel_t end() const { return std::default_sentinel; };
+
+private:
+  const Children* children = nullptr;
+  std::optional<ElementName> elementName;
+};
+
+inline ObjectRange<XMLObject, false> XMLObject::childrenNamed(const ElementName& elementName) {
+  return ObjectRange<XMLObject, false>(children, elementName);
+}
+
+inline ObjectRange<const XMLObject, false> XMLObject::childrenNamed(const ElementName& elementName) const {
+  return ObjectRange<const XMLObject, false>(children, elementName);
+}
+
+/**
+ * @brief Member of a generated class referring to a required child element of type T.
+ *
+ * The member keeps the position of the child within the children of the object. If the XML-tree
+ * is created lazily, only the object of the child is created when the member is accessed.
+ */
+template<typename T>
+class RequiredChild {
+public:
+  RequiredChild(const Children& children, uint32_t position) : children(&children), position(position) {};
+
+  T& get() const { return static_cast<T&>(children->object(position)); };
+  operator T&() const { return get(); };
+  T& operator*() const { return get(); };
+  T* operator->() const { return &get(); };
+
+private:
+  const Children* children;
+  uint32_t position;
+};
+
+/**
+ * @brief Member of a generated class referring to an optional child element of type T, see @ref RequiredChild.
+ */
+template<typename T>
+class OptionalChild {
+public:
+  OptionalChild(const Children& children, std::optional<uint32_t> position) : children(&children), position(position) {};
+
+  bool has_value() const { return position.has_value(); };
+  explicit operator bool() const { return position.has_value(); };
+  T& value() const { return static_cast<T&>(children->object(position.value())); };
+  T& operator*() const { return value(); };
+  T* operator->() const { return &value(); };
+  operator std::optional< std::reference_wrapper<T> >() const {
+    return position ? std::optional< std::reference_wrapper<T> >(value()) : std::nullopt;
+  };
+
+private:
+  const Children* children;
+  std::optional<uint32_t> position;
+};
+
+/**
+ * @brief Member of a generated class referring to a sequence of child elements of type T, see @ref RequiredChild.
+ */
+template<typename T>
+class ChildList {
+public:
+  class iterator {
+  public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef T* pointer;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::forward_iterator_tag iterator_category;
+
+    iterator() = default;
+    iterator(const Children* children, const uint32_t* position) : children(children), position(position) {};
+
+    reference operator*() const { return static_cast<T&>(children->object(*position)); };
+    pointer operator->() const { return &**this; };
+    iterator& operator++() { position++; return *this; };
+    iterator operator++(int) { iterator previous = *this; position++; return previous; };
+    bool operator==(const iterator& other) const { return position == other.position; };
+
+  private:
+    const Children* children = nullptr;
+    const uint32_t* position = nullptr;
+  };
+  typedef iterator const_iterator;
+
+  ChildList(const Children& children, std::pmr::vector<uint32_t>&& positions) : children(&children), positions(std::move(positions)) {};
+
+  iterator begin() const { return iterator(children, positions.data()); };
+  iterator end() const { return iterator(children, positions.data() + positions.size()); };
+  size_t size() const { return positions.size(); };
+  bool empty() const { return positions.empty(); };
+  T& operator[](size_t i) const { return static_cast<T&>(children->object(positions[i])); };
+  T& front() const { return (*this)[0]; };
+  T& back() const { return (*this)[positions.size() - 1]; };
+
+private:
+  const Children* children;
+  std::pmr::vector<uint32_t> positions;
+};
+
+/// @brief Memory resource serializing all allocations from another memory resource
+class SynchronizedResource : public std::pmr::memory_resource {
+public:
+  SynchronizedResource(std::pmr::memory_resource* upstream) : upstream(upstream) {};
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    return upstream->allocate(bytes, alignment);
+  };
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    upstream->deallocate(p, bytes, alignment);
+  };
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  };
+
+  std::pmr::memory_resource* upstream;
+  std::mutex mutex;
+};
+
+template<typename T> XMLObject* createInstance(const Namespace& xmlns, const ClassName& className, ElementData& element) {
+  T* object = element.arena ?
+    new (element.arena->allocate(sizeof(T), alignof(T))) T(xmlns, className, element, T::defaults) :
+    new T(xmlns, className, element, T::defaults);
+  if constexpr ( HasClassType<T>::value ) {
+    static_cast<XMLObject*>(object)->objectType = T::classType;
+  }
+  return object;
+}
+
+/**
+ * @brief A class owning an XML-tree allocated from an arena.
+ *
+ * All objects of the tree including their attributes, children, and strings are allocated from a
+ * monotonic arena owned by the document. When the document is destroyed, the memory of the entire
+ * tree is released at once without destroying the objects one by one. The arena obtains its memory
+ * from an upstream memory resource which can be provided by the caller, e.g., a 
+ * `std::pmr::synchronized_pool_resource` shared by multiple threads.
+ *
+ * Objects of the tree must not be deleted individually and must not be used after the document is
+ * destroyed.
+ *
+ * Example usage:
+ * ```
+ * ParserContext context;
+ * Document document;
+ * XMLObject& root = context.parseFile(filename, document);
+ * ```
+ */
+class Document {
+public:
+  Document(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : arena(upstream), synchronizedArena(&arena) {};
+  Document(const Document&) = delete;
+  Document& operator=(const Document&) = delete;
+
+  /// @brief Returns the root of the XML-tree or `nullptr` if nothing is parsed into the document.
+  XMLObject* root() const { return rootObject; };
+
+  /// @brief Returns the arena from which the XML-tree is allocated.
+  std::pmr::memory_resource* resource() { return &arena; };
+
+private:
+  friend class ParserContext;
+  std::pmr::monotonic_buffer_resource arena;
+  // used instead of the arena if subtrees are constructed concurrently
+  SynchronizedResource synchronizedArena;
+  XMLObject* rootObject = nullptr;
+};
+
+/**
+ * @brief Index of objects by the values of their attributes of type `xsd:ID`.
+ *
+ * The index is filled while parsing if it is given to @ref ParserContext::setIdIndex(). Thus,
+ * references such as attributes of type `xsd:IDREF` can be resolved without searching the
+ * XML-tree. The index keeps its own copies of the IDs, which are allocated by the index and not from
+ * the memory resource of a document, i.e., the index remains valid if IDs of the objects are changed
+ * and can be destroyed after the document, but must not be used after the objects are deleted.
+ *
+ * Example usage:
+ * ```
+ * XML::IdIndex ids;
+ * XML::ParserContext context;
+ * context.setIdIndex(&ids);
+ * std::unique_ptr<XML::XMLObject> root(context.parse(file));
+ * for ( auto& sequenceFlow : root->find<XML::bpmn::tSequenceFlow>() ) {
+ *   XML::bpmn::tFlowNode* source = ids.getById<XML::bpmn::tFlowNode>(sequenceFlow.get().sourceRef.value);
+ * }
+ * ```
+ */
+class IdIndex {
+public:
+  /// @brief Returns the object with the given ID or `nullptr` if there is no such object.
+  XMLObject* getById(std::string_view id) const {
+    auto it = objects.find(id);
+    return it != objects.end() ? it->second : nullptr;
+  };
+
+  /// @brief Returns the object with the given ID if it is of type T, or `nullptr` otherwise.
+  template<typename T> T* getById(std::string_view id) const {
+    XMLObject* object = getById(id);
+    return object ? object->is<T>() : nullptr;
+  };
+
+  /// @brief Returns the number of indexed objects.
+  size_t size() const { return objects.size(); };
+
+  /// @brief Removes all objects from the index.
+  void clear() { objects.clear(); };
+
+private:
+  friend class XMLObject;
+  // Hash allowing to look up IDs by std::string_view
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view value) const { return std::hash<std::string_view>()(value); }
+  };
+  // the first object with an ID is kept, objects may be added concurrently if subtrees are constructed concurrently
+  void add(std::string_view id, XMLObject& object) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if ( objects.find(id) == objects.end() ) {
+      objects.emplace(std::string(id), &object);
+    }
+  };
+  std::unordered_map<std::string, XMLObject*, Hash, std::equal_to<>> objects;
+  std::mutex mutex;
+};
+
+/**
+ * @brief A class providing a reusable context for parsing XML-documents.
+ *
+ * The context initializes the XML platform and creates a parser once. Both are reused for all
+ * documents parsed with the context, and released when the context is destroyed. 
+ * A context must not be used by multiple threads at the same time, however, each thread can
+ * have its own context.
+ *
+ * For large documents, the context can construct the XML objects of large subtrees concurrently,
+ * see @ref setParallelConstruction().
+ *
+ * Example usage:
+ * ```
+ * ParserContext context;
+ * for ( auto& message : messages ) {
+ *   std::unique_ptr<XMLObject> root(context.parseString(message));
+ *   ...
+ * }
+ * ```
+ */
+class ParserContext {
+public:
+  ParserContext();
+  ~ParserContext();
+  ParserContext(const ParserContext&) = delete;
+  ParserContext& operator=(const ParserContext&) = delete;
+
+  /**
+   * @brief Construct the XML objects of large subtrees concurrently.
+   *
+   * If enabled, the objects are created after the document is parsed. All subtrees with at least
+   * the given number of elements are constructed as tasks of a pool of worker threads. The
+   * resulting XML-tree is identical to the XML-tree created sequentially. If the objects are
+   * allocated from the arena of a @ref Document, all allocations are serialized.
+   *
+   * @param threshold The minimum number of elements of a subtree to be constructed as a separate
+   * task, if 0 all objects are created sequentially while parsing.
+   * @param threads The number of threads including the calling thread, if 0 the number of hardware
+   * threads is used.
+   */
+  void setParallelConstruction(size_t threshold, unsigned int threads = 0);
+
+  /**
+   * @brief Create XML objects lazily.
+   *
+   * If enabled, only the root object is created when parsing a document. The objects of the
+   * children of an element and their textual content are created when the children are accessed
+   * for the first time, e.g., using @ref XMLObject::children, @ref XMLObject::getChildren(), or
+   * @ref XMLObject::find(). Generated classes with members for child elements access their
+   * children when they are created. Parallel construction is not used in lazy mode.
+   *
+   * @param lazy Whether objects are created lazily.
+   */
+  void setLazyConstruction(bool lazy);
+
+  /**
+   * @brief Index objects by their IDs.
+   *
+   * If an index is given, the objects of generated classes created by subsequent parses add the
+   * values of their attributes of type `xsd:ID` to the index. Objects created lazily are added
+   * when they are created.
+   *
+   * @param ids The index to which the objects are added, or `nullptr` to disable indexing.
+   */
+  void setIdIndex(IdIndex* ids);
+
+  /**
+   * @brief Create an XMLObject from the input stream.
+   *
+   * @param xmlStream The input stream containing the XML data.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  XMLObject* parse(std::istream& xmlStream);
+
+  /**
+   * @brief Create an XMLObject from a Xerces input source.
+   *
+   * @param inputSource The input source providing the XML data.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  XMLObject* parse(const xercesc::InputSource& inputSource);
+
+  /**
+   * @brief Create an XMLObject from a string representation of XML.
+   *
+   * @param xmlString The string containing the XML data.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  XMLObject* parseString(const std::string& xmlString);
+
+  /**
+   * @brief Create an XMLObject from a buffer containing XML.
+   *
+   * The buffer is read in place and must remain valid until the function returns.
+   *
+   * @param xmlBuffer The buffer containing the XML data.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  XMLObject* parseBuffer(std::string_view xmlBuffer);
+
+  /**
+   * @brief Create an XMLObject from an XML file.
+   *
+   * The file is mapped into memory and read in place.
+   *
+   * @param filename The path to the XML file.
+   * @return A pointer to the created XMLObject.
+   * @throws std::runtime_error if loading the file or parsing the XML fails.
+   */
+  XMLObject* parseFile(const std::string& filename);
+
+  /**
+   * @brief Create an XML-tree in the arena of a document from the input stream.
+   *
+   * @param xmlStream The input stream containing the XML data.
+   * @param document The empty document owning the created XML-tree.
+   * @return A reference to the root of the XML-tree.
+   * @throws std::runtime_error if the document is not empty or parsing the XML fails.
+   */
+  XMLObject& parse(std::istream& xmlStream, Document& document);
+
+  /**
+   * @brief Create an XML-tree in the arena of a document from a Xerces input source.
+   *
+   * @param inputSource The input source providing the XML data.
+   * @param document The empty document owning the created XML-tree.
+   * @return A reference to the root of the XML-tree.
+   * @throws std::runtime_error if the document is not empty or parsing the XML fails.
+   */
+  XMLObject& parse(const xercesc::InputSource& inputSource, Document& document);
+
+  /**
+   * @brief Create an XML-tree in the arena of a document from a string representation of XML.
+   *
+   * @param xmlString The string containing the XML data.
+   * @param document The empty document owning the created XML-tree.
+   * @return A reference to the root of the XML-tree.
+   * @throws std::runtime_error if the document is not empty or parsing the XML fails.
+   */
+  XMLObject& parseString(const std::string& xmlString, Document& document);
+
+  /**
+   * @brief Create an XML-tree in the arena of a document from a buffer containing XML.
+   *
+   * @param xmlBuffer The buffer containing the XML data.
+   * @param document The empty document owning the created XML-tree.
+   * @return A reference to the root of the XML-tree.
+   * @throws std::runtime_error if the document is not empty or parsing the XML fails.
+   */
+  XMLObject& parseBuffer(std::string_view xmlBuffer, Document& document);
+
+  /**
+   * @brief Create an XML-tree in the arena of a document from an XML file.
+   *
+   * @param filename The path to the XML file.
+   * @param document The empty document owning the created XML-tree.
+   * @return A reference to the root of the XML-tree.
+   * @throws std::runtime_error if the document is not empty, or loading the file or parsing the XML fails.
+   */
+  XMLObject& parseFile(const std::string& filename, Document& document);
+
+  /**
+   * @brief Visit each element of type T in the input stream without creating the entire XML-tree.
+   *
+   * Only the objects of the outermost elements of type T and their descendants are created. Each
+   * of these objects is passed to the callback and deleted afterwards. Thus, the memory required is
+   * bounded by the largest subtree of an element of type T rather than by the size of the document.
+   *
+   * Example usage:
+   * ```
+   * context.forEach<XML::bpmn::tTask>(xmlStream, [](XML::bpmn::tTask& task) {
+   *   ...
+   * });
+   * ```
+   *
+   * @param xmlStream The input stream containing the XML data.
+   * @param callback The function called for each element of type T.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  template<typename T>
+  void forEach(std::istream& xmlStream, const std::function<void(T& object)>& callback) {
+    forEach(xmlStream, &creates<T>, [&callback](XMLObject& object) { callback(*object.get<T>()); });
+  }
+
+  /**
+   * @brief Visit each element of type T provided by a Xerces input source without creating the entire XML-tree.
+   *
+   * @param inputSource The input source providing the XML data.
+   * @param callback The function called for each element of type T.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  template<typename T>
+  void forEach(const xercesc::InputSource& inputSource, const std::function<void(T& object)>& callback) {
+    forEach(inputSource, &creates<T>, [&callback](XMLObject& object) { callback(*object.get<T>()); });
+  }
+
+private:
+  friend class PushParser;
+  XMLObject* parse(const xercesc::InputSource& inputSource, std::pmr::memory_resource* arena);
+  void forEach(std::istream& xmlStream, bool (*matches)(const TypeId& type), const std::function<void(XMLObject& object)>& callback);
+  void forEach(const xercesc::InputSource& inputSource, bool (*matches)(const TypeId& type), const std::function<void(XMLObject& object)>& callback);
+
+  // Returns true if objects of the given type are of type T or a class derived from T.
+  template<typename T>
+  static bool creates(const TypeId& type) {
+    if constexpr ( std::is_same_v<T, XMLObject> ) {
+      return true;
+    }
+    else {
+      static_assert(HasClassType<T>::value, "Streaming only supports generated classes");
+      return type.isDerivedFrom(T::classType);
+    }
+  }
+
+  std::unique_ptr<SAX2Handler> handler;
+  std::unique_ptr<xercesc::SAX2XMLReader> reader;
+  std::unique_ptr<TaskPool> taskPool;
+};
+
+/**
+ * @brief A class parsing an XML-document which is provided in chunks.
+ *
+ * The chunks of the document are passed to the parser as they arrive, e.g., from a socket. The
+ * XML-tree is created by a separate thread while further chunks are received. When all chunks are
+ * pushed, @ref finish() returns the root of the XML-tree.
+ *
+ * Example usage:
+ * ```
+ * PushParser parser;
+ * while ( size_t size = receive(socket, buffer) ) {
+ *   parser.push(std::string_view(buffer, size));
+ *   if ( parser.isComplete() ) {
+ *     break;
+ *   }
+ * }
+ * std::unique_ptr<XMLObject> root(parser.finish());
+ * ```
+ */
+class PushParser {
+public:
+  /// @brief Create a parser creating the XML-tree on the heap.
+  PushParser();
+
+  /// @brief Create a parser creating the XML-tree in the arena of the given empty document.
+  PushParser(Document& document);
+
+  ~PushParser();
+  PushParser(const PushParser&) = delete;
+  PushParser& operator=(const PushParser&) = delete;
+
+  /**
+   * @brief Pass the next chunk of the document to the parser.
+   *
+   * The chunk is copied and parsed concurrently.
+   *
+   * @param chunk The next bytes of the document.
+   * @throws std::runtime_error if parsing the XML has already failed or the parser is finished.
+   */
+  void push(std::string_view chunk);
+
+  /// @brief Returns true if the root element of the document is closed.
+  bool isComplete() const { return complete; };
+
+  /**
+   * @brief Signal the end of the document and wait until the XML-tree is created.
+   *
+   * @return A pointer to the root of the XML-tree, which is owned by the caller unless the
+   * XML-tree is created in the arena of a document.
+   * @throws std::runtime_error if parsing the XML fails.
+   */
+  XMLObject* finish();
+
+private:
+  void start(Document* document);
+
+  ParserContext context;
+  std::unique_ptr<PushInputSource> input;
+  std::thread worker;
+  std::atomic<bool> complete = false;
+  std::atomic<bool> failed = false;
+  bool finished = false;
+  XMLObject* root = nullptr;
+  Document* document = nullptr;
+  std::exception_ptr exception;
+};
+
+/**
+ * @brief A thread-safe cache of XML-trees loaded from files.
+ *
+ * The cache provides shared immutable XML-trees of files which are loaded repeatedly, e.g., by
+ * many requests of a service. A cached XML-tree is used as long as the modification time and the
+ * size of the file are unchanged, otherwise the file is loaded again. If several threads request a
+ * file which is not cached, the file is only loaded once and all threads receive the same tree.
+ *
+ * Each XML-tree is created in the arena of a document, and the memory allocated by the arena is
+ * charged to the memory budget of the cache. If the budget is exceeded, the least recently used
+ * XML-trees are removed from the cache. XML-trees handed out remain valid until the last
+ * `std::shared_ptr` referring to them is released.
+ *
+ * Example usage:
+ * ```
+ * XML::DocumentCache cache(256 * 1024 * 1024);
+ * std::shared_ptr<const XML::XMLObject> root = cache.get("diagram.bpmn");
+ * ```
+ */
+class DocumentCache {
+public:
+  /// @brief Counters of the cache
+  struct Statistics {
+    size_t hits; ///< Number of requests answered by a cached XML-tree or a tree being loaded
+    size_t misses; ///< Number of requests for which the file had to be loaded
+    size_t evictions; ///< Number of XML-trees removed to meet the memory budget
+    size_t invalidations; ///< Number of XML-trees removed because the file changed
+    size_t documents; ///< Number of cached XML-trees
+    size_t bytes; ///< Memory allocated for the cached XML-trees
+  };
+
+  /**
+   * @brief Create a cache.
+   *
+   * @param budget The maximum number of bytes allocated for all cached XML-trees.
+   */
+  DocumentCache(size_t budget);
+  DocumentCache(const DocumentCache&) = delete;
+  DocumentCache& operator=(const DocumentCache&) = delete;
+
+  /**
+   * @brief Get the XML-tree of an XML file.
+   *
+   * @param filename The path to the XML file.
+   * @return The root of the shared XML-tree.
+   * @throws std::runtime_error if the file cannot be loaded.
+   */
+  std::shared_ptr<const XMLObject> get(const std::string& filename);
+
+  /// @brief Removes all XML-trees from the cache. XML-trees handed out remain valid.
+  void clear();
+
+  /// @brief Returns the counters of the cache.
+  Statistics getStatistics() const;
+
+private:
+  struct Entry {
+    std::filesystem::file_time_type modified;
+    uintmax_t size;
+    uint64_t generation; // distinguishes entries of the same file
+    std::shared_future< std::shared_ptr<const XMLObject> > root;
+    size_t bytes = 0; // memory allocated for the XML-tree, 0 while the tree is loaded
+    std::list<std::string>::iterator position; // position of the filename in recent
+  };
+
+  size_t budget;
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+  std::list<std::string> recent; // filenames of the entries from most to least recently used
+  uint64_t generations = 0;
+  Statistics statistics = {};
+
+  void erase(std::unordered_map<std::string, Entry>::iterator entry);
+  void evict();
+};
+
+/**
+ * @brief A class writing XML-trees to an output stream, a string, or a file descriptor.
+ *
+ * The serializer writes the XML-tree in a single pass without creating a string for each object.
+ * When writing to a file descriptor, the output is collected in a buffer of fixed size which is
+ * written whenever it is full, and when the serializer is flushed or destroyed. The exact size of
+ * the output can be obtained by @ref size() and @ref formattedSize(), e.g., to reserve a string
+ * before writing to it. As this requires an additional traversal of the XML-tree, the serializer
+ * does not reserve the size by itself.
+ *
+ * Example usage:
+ * ```
+ * XML::Serializer serializer(std::cout);
+ * serializer.format(*root);
+ * ```
+ */
+class Serializer {
+public:
+  /// @brief Create a serializer writing to an output stream.
+  Serializer(std::ostream& stream) : stream(&stream) {};
+
+  /// @brief Create a serializer appending to a string.
+  Serializer(std::string& buffer) : target(&buffer) {};
+
+  /// @brief Create a serializer writing to a file descriptor which is not closed by the serializer.
+  Serializer(int fileDescriptor) : fileDescriptor(fileDescriptor) { buffer.reserve(bufferSize); };
+
+  Serializer(const Serializer&) = delete;
+  Serializer& operator=(const Serializer&) = delete;
+
+  /// @brief Writes the remaining output to the file descriptor, errors are ignored.
+  ~Serializer();
+
+  /**
+   * @brief Write the XMLObject and its children.
+   *
+   * The output is identical to @ref XMLObject::stringify().
+   */
+  Serializer& write(const XMLObject& object);
+
+  /**
+   * @brief Write the XMLObject and its children with each element on a separate line.
+   *
+   * The output is identical to @ref XMLObject::format().
+   */
+  Serializer& format(const XMLObject& object, std::string_view indentation = "\t", unsigned int depth = 0);
+
+  /// @brief Write the text as it is, e.g., an XML declaration.
+  Serializer& write(std::string_view text);
+
+  /**
+   * @brief Sets whether default attributes of the classes are written.
+   *
+   * By default, the default attributes of the class of an object which are not given by the element
+   * are written after the attributes of the element. If disabled, only the attributes of the elements
+   * are written, i.e., the output does not contain attributes which are not in the parsed document.
+   */
+  Serializer& setDefaultAttributes(bool write) { defaultAttributes = write; return *this; };
+
+  /**
+   * @brief Writes the buffered output to the file descriptor.
+   *
+   * @throws std::runtime_error if writing to the file descriptor fails.
+   */
+  void flush();
+
+  /// @brief Returns the number of characters written by @ref write(const XMLObject& object).
+  static size_t size(const XMLObject& object, bool defaultAttributes = true);
+
+  /// @brief Returns the number of characters written by @ref format().
+  static size_t formattedSize(const XMLObject& object, std::string_view indentation = "\t", unsigned int depth = 0, bool defaultAttributes = true);
+
+private:
+  static constexpr size_t bufferSize = 64 * 1024;
+  std::ostream* stream = nullptr;
+  std::string* target = nullptr;
+  int fileDescriptor = -1;
+  bool defaultAttributes = true; // whether default attributes of the classes are written
+  std::string buffer; // output not yet written to the file descriptor
+  std::string indentationUnit; // indentation of which the indentations are repeated
+  std::string indentations; // indentation repeated for the deepest element written so far
+};
+
+template<typename T>
+void XMLObject::forEach(std::istream& xmlStream, const std::function<void(T& object)>& callback) {
+  ParserContext().forEach<T>(xmlStream, callback);
+}
+
+/**
+ * @brief A path query compiled once and evaluated on XML-trees.
+ *
+ * Queries use a subset of XPath. A path consists of steps separated by `/` for children and `//`
+ * for descendants. A leading `/` selects the context object itself with the first step, a
+ * leading `//` selects the context object and its descendants. Otherwise, the first step selects
+ * children of the context object. Each step has one of the following tests:
+ * - `name` selects elements with the given element name, a namespace prefix is ignored,
+ * - `type(tName)` selects objects of the generated class `tName` or a class derived from it,
+ * - `*` selects all elements,
+ *
+ * followed by any number of attribute predicates:
+ * - `[@name]` selects elements having the attribute,
+ * - `[@name='value']` selects elements having the attribute with the given value,
+ * - `[@name!='value']` selects elements not having the attribute with the given value.
+ *
+ * Default attributes of generated classes are considered by predicates. Each object is selected at
+ * most once, objects are visited without creating intermediate containers.
+ *
+ * Example usage:
+ * ```
+ * XML::Query tasks("type(tProcess)[@isExecutable='true']//type(tTask)");
+ * tasks.forEach(*root, [](XML::XMLObject& task) { std::cout << task.className << std::endl; });
+ * ```
+ */
+class Query {
+public:
+  /**
+   * @brief Compiles the query.
+   *
+   * @param path The path of the query.
+   * @throws std::runtime_error if the path is invalid or refers to an unknown class.
+   */
+  Query(std::string_view path);
+
+  /// @brief Calls the callback for each object selected by the query from the context object.
+  void forEach(XMLObject& context, const std::function<void(XMLObject& object)>& callback) const;
+
+  /// @brief Returns the first object selected by the query from the context object or `nullptr` if there is none.
+  XMLObject* first(XMLObject& context) const;
+
+  /// @brief Returns all objects selected by the query from the context object.
+  std::vector<std::reference_wrapper<XMLObject>> select(XMLObject& context) const;
+
+  /// @brief Returns the number of objects selected by the query from the context object.
+  size_t count(XMLObject& context) const;
+
+private:
+  enum class Axis { Self, Child, Descendant, DescendantOrSelf };
+  struct Predicate {
+    AttributeName name;
+    std::optional<std::string> value;
+    bool negated = false;
+  };
+  struct Step {
+    Axis axis;
+    std::optional<ElementName> elementName; ///< Element name to be matched, if any
+    std::vector<TypeId> types; ///< Type ids of which one must be matched, if not empty
+    std::vector<Predicate> predicates;
+  };
+  std::vector<Step> steps;
+  bool mayRepeat = false; // objects may be reached along several paths
+
+  bool matches(const Step& step, XMLObject& object) const;
+  bool select(size_t index, XMLObject& candidate, const std::function<bool(XMLObject& object)>& visit) const;
+  bool descend(size_t index, XMLObject& object, const std::function<bool(XMLObject& object)>& visit) const;
+  bool evaluate(size_t index, XMLObject& object, const std::function<bool(XMLObject& object)>& visit) const;
+  bool evaluate(XMLObject& context, const std::function<bool(XMLObject& object)>& visit) const;
+};
+
+template<typename T> class Frozen;
+template<> class Frozen<XMLObject>;
+template<typename T, bool Recursive> class FrozenRange;
+
+/**
+ * @brief An immutable compact copy of an XML-tree for read-only access.
+ *
+ * The elements are stored in preorder in a structure of arrays, i.e., the descendants of an
+ * element directly follow the element and end at the position stored for the element. All
+ * attribute values and textual contents are kept in a single string pool. Thus, iterating over
+ * children or descendants is a linear scan over a few arrays instead of following pointers.
+ *
+ * Elements are accessed using @ref Frozen views. For each generated class, schematic++ generates a
+ * specialization of @ref Frozen providing the members of the class. Views refer to the document
+ * and must not be used after the document is moved or deleted.
+ *
+ * Example usage:
+ * ```
+ * XML::FrozenDocument document = root->freeze();
+ * for ( XML::Frozen<XML::bpmn::tTask> task : document.root().descendants<XML::bpmn::tTask>() ) {
+ *   std::cout << task.id().value_or("") << std::endl;
+ * }
+ * ```
+ */
+class FrozenDocument {
+public:
+  /**
+   * @brief Creates the frozen document.
+   *
+   * @param root The root of the XML-tree which is copied into the document.
+   * @throws std::runtime_error if the XML-tree is too large to be frozen.
+   */
+  FrozenDocument(const XMLObject& root);
+
+  /**
+   * @brief Maps a snapshot written by @ref writeSnapshot() into memory.
+   *
+   * The snapshot is mapped read-only and shared, i.e., the arrays of the document are not copied
+   * and all processes mapping the same snapshot share its pages. The arrays are validated once when
+   * the snapshot is mapped, such that all indices and ranges in the arrays can be used without
+   * further checks.
+   *
+   * @param filename The path to the snapshot.
+   * @return The frozen document referring to the mapped snapshot.
+   * @throws std::runtime_error if the snapshot cannot be mapped or is invalid, or if the fingerprint
+   *         of the generated classes or of a class used in the snapshot does not match the
+   *         fingerprint of the snapshot.
+   */
+  static FrozenDocument mapSnapshot(const std::string& filename);
+
+  /**
+   * @brief Writes a snapshot of the document which can be mapped by @ref mapSnapshot().
+   *
+   * Besides the arrays of the document, the snapshot contains a fingerprint of all generated classes
+   * and the fingerprints of the generated classes used in the document. The snapshot uses the byte
+   * order of the machine.
+   *
+   * @param filename The path to the snapshot.
+   * @throws std::runtime_error if the snapshot cannot be written.
+   */
+  void writeSnapshot(const std::string& filename) const;
+
+  /// @brief Returns a view of the root element.
+  Frozen<XMLObject> root() const;
+
+  /// @brief Returns the number of elements of the document.
+  size_t size() const { return elements.size(); };
+
+  /// @brief Returns the size of the pool of attribute values and textual contents.
+  size_t stringsSize() const { return strings.size(); };
+
+private:
+  friend class Frozen<XMLObject>;
+  template<typename T, bool Recursive> friend class FrozenRange;
+  struct Builder;
+
+  // Returns a fingerprint of all generated classes, which changes if a class is added, removed, renumbered, or changed
+  static uint64_t schemaFingerprint();
+
+  // position of a string in the string pool
+  struct StringRange {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  // properties shared by all elements of the same class, names are given by their positions in names
+  struct ElementClass {
+    uint32_t className;
+    uint32_t xmlns;
+    uint32_t prefix;
+    uint32_t defaultsOffset; // position of the default attributes of the class, which follow the attributes of all elements
+    uint32_t defaultsCount;
+    TypeId type;
+  };
+
+  std::vector<ElementClass> classes;
+  std::vector<Name> names; // names of all classes, namespaces, prefixes, elements, and attributes used in the document
+
+  std::span<const uint32_t> elements; // position of the class of each element in classes
+  std::span<const uint32_t> parents;
+  std::span<const uint32_t> ends; // position after the last descendant of each element
+  std::span<const uint32_t> elementNames; // position of the name of each element in names
+  std::span<const uint32_t> attributeOffsets; // position of the first attribute of each element and of the end of all attributes of elements
+  std::span<const StringRange> textContents;
+  std::span<const uint32_t> attributeNames; // position of the name of each attribute in names
+  std::span<const StringRange> attributeValues;
+  std::string_view strings;
+
+  // owner of the memory of the arrays, i.e., of the copy of the XML-tree or of the mapped snapshot
+  std::shared_ptr<const void> storage;
+
+  FrozenDocument() = default;
+  std::string_view get(StringRange range) const { return strings.substr(range.offset, range.size); };
+
+  template<typename T> bool isDerivedFrom(uint32_t index) const {
+    if constexpr ( std::is_same_v<std::remove_cv_t<T>, XMLObject> ) {
+      return true;
+    }
+    else {
+      static_assert(HasClassType<T>::value, "Frozen documents only support generated classes");
+      return classes[elements[index]].type.isDerivedFrom(T::classType);
+    }
+  };
+};
+
+/**
+ * @brief View of the children or descendants of type T of an element of a frozen document.
+ *
+ * Children are visited by skipping the descendants of each child, descendants are visited by a
+ * linear scan. The view yields @ref Frozen views and can be combined with the range adaptors of
+ * the standard library.
+ */
+template<typename T, bool Recursive>
+class FrozenRange : public std::ranges::view_interface< FrozenRange<T, Recursive> > {
+public:
+  class iterator {
+  public:
+    typedef Frozen<T> value_type;
+    typedef Frozen<T> reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::forward_iterator_tag iterator_concept;
+    typedef std::input_iterator_tag iterator_category;
+
+    iterator() = default;
+    iterator(const FrozenRange* range, uint32_t position) : range(range), position(position) { settle(); };
+
+    reference operator*() const { return Frozen<T>(*range->document, position); };
+    iterator& operator++() { position = ( Recursive ? position + 1 : range->document->ends[position] ); settle(); return *this; };
+    iterator operator++(int) { iterator previous = *this; ++*this; return previous; };
+    bool operator==(const iterator& other) const { return position == other.position; };
+    bool operator==(std::default_sentinel_t) const { return position == range->last; };
+
+  private:
+    const FrozenRange* range = nullptr;
+    uint32_t position = 0;
+
+    // moves to the next element selected by the view unless the current element is selected
+    void settle() {
+      while ( position < range->last && !range->selects(position) ) {
+        position = ( Recursive ? position + 1 : range->document->ends[position] );
+      }
+    };
+  };
+
+  FrozenRange() = default;
+  FrozenRange(const FrozenDocument& document, uint32_t index, std::optional<ElementName> elementName = std::nullopt)
+    : document(&document), first(index + 1), last(document.ends[index]), elementName(elementName) {};
+
+  iterator begin() const { return iterator(this, first); };
+  std::default_sentinel_t end() const { return std::default_sentinel; };
+
+private:
+  const FrozenDocument* document = nullptr;
+  uint32_t first = 0; // position of the first candidate
+  uint32_t last = 0; // position after the last candidate
+  std::optional<ElementName> elementName;
+
+  bool selects(uint32_t position) const {
+    return ( !elementName || document->names[document->elementNames[position]] == *elementName ) && document->isDerivedFrom<T>(position);
+  };
+};
+
+/**
+ * @brief View of an element of a frozen document.
+ *
+ * A view consists of a pointer to the document and the position of the element and can be
+ * copied cheaply. Views of generated classes are derived from this class and provide the
+ * attributes and child elements declared in the schema.
+ */
+template<> class Frozen<XMLObject> {
+public:
+  Frozen(const FrozenDocument& document, uint32_t index) : document(&document), index(index) {};
+
+  /// @brief Returns the position of the element in preorder.
+  uint32_t position() const { return index; };
+
+  const ClassName& className() const { return document->names[elementClass().className]; };
+  const Namespace& xmlns() const { return document->names[elementClass().xmlns]; };
+  const Namespace& prefix() const { return document->names[elementClass().prefix]; };
+  const ElementName& elementName() const { return document->names[document->elementNames[index]]; };
+  std::string_view textContent() const { return document->get(document->textContents[index]); };
+
+  /// @brief Returns the parent element or `std::nullopt` for the root element.
+  std::optional< Frozen<XMLObject> > parent() const;
+
+  /// @brief Returns true if the element is of type T.
+  template<typename T> bool is() const { return document->isDerivedFrom<T>(index); };
+
+  /**
+   * @brief Returns a view of type T of the element.
+   *
+   * @return The view or `std::nullopt` if the element is not of type T.
+   */
+  template<typename T> std::optional< Frozen<T> > as() const {
+    if ( !is<T>() ) {
+      return std::nullopt;
+    }
+    return Frozen<T>(*document, index);
+  };
+
+  /// @brief Returns the number of attributes of the element, not including default attributes.
+  size_t attributeCount() const { return document->attributeOffsets[index + 1] - document->attributeOffsets[index]; };
+
+  /**
+   * @brief Get the value of an optional attribute with the specified attribute name.
+   *
+   * If the element has no such attribute, the value of the default attribute of the class is returned.
+   *
+   * @param attributeName The name of the attribute without namespace prefix.
+   * @return The value or `std::nullopt` if the attribute is not found.
+   */
+  std::optional<std::string_view> getOptionalAttributeByName(const AttributeName& attributeName) const;
+
+  /**
+   * @brief Get the value of a required attribute with the specified attribute name.
+   *
+   * @param attributeName The name of the attribute without namespace prefix.
+   * @return The value of the attribute.
+   * @throws std::runtime_error if the required attribute is not found.
+   */
+  std::string_view getRequiredAttributeByName(const AttributeName& attributeName) const;
+
+  /// @brief Get a view of all children of type T.
+  template<typename T> FrozenRange<T, false> childrenOfType() const { return FrozenRange<T, false>(*document, index); };
+
+  /// @brief Get a view of all children with the specified element name.
+  FrozenRange<XMLObject, false> childrenNamed(const ElementName& elementName) const { return FrozenRange<XMLObject, false>(*document, index, elementName); };
+
+  /// @brief Get a view of all descendants of type T in document order.
+  template<typename T> FrozenRange<T, true> descendants() const { return FrozenRange<T, true>(*document, index); };
+
+  template<typename T> std::optional< Frozen<T> > getOptionalChild() const {
+    auto children = childrenOfType<T>();
+    if ( children.empty() ) {
+      return std::nullopt;
+    }
+    return children.front();
+  };
+
+  /// @throws std::runtime_error if the required child is not found.
+  template<typename T> Frozen<T> getRequiredChild() const {
+    if ( auto child = getOptionalChild<T>() ) {
+      return *child;
+    }
+    throw std::runtime_error("Failed to get required child of element '" + std::string(elementName()) + "'");
+  };
+
+  std::optional< Frozen<XMLObject> > getOptionalChildByName(const ElementName& elementName) const;
+
+  /// @throws std::runtime_error if the required child is not found.
+  Frozen<XMLObject> getRequiredChildByName(const ElementName& elementName) const;
+
+  bool operator==(const Frozen<XMLObject>& other) const { return document == other.document && index == other.index; };
+
+protected:
+  const FrozenDocument* document;
+  uint32_t index;
+
+  const FrozenDocument::ElementClass& elementClass() const { return document->classes[document->elements[index]]; };
+};
+
+inline Frozen<XMLObject> FrozenDocument::root() const {
+  return Frozen<XMLObject>(*this, 0);
+}
+
+/// @brief  Allows printing of stringified XML object
+std::ostream& operator<<(std::ostream& os, const XMLObject* obj);
+/// @brief  Allows printing of stringified XML object
+std::ostream& operator<<(std::ostream& os, const XMLObject& obj);
+
+} // end namespace XML
+
+/// @brief Allows iterators of views of XML objects to outlive the view
+template<typename T, bool Recursive> inline constexpr bool std::ranges::enable_borrowed_range<XML::ObjectRange<T, Recursive>> = true;
 
 #endif // XML_H
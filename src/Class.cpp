@@ -23,20 +23,124 @@
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
+#include <utility>
 
 using namespace std;
 
 extern bool verbose;
+extern bool typedAttributes;
 extern string schemaName;
 extern vector<string> schemaNames;
 extern string cppNamespace;
 
+//returns the C++ type of a typed attribute member, or an empty string if the attribute is kept as Attribute
+static string getTypedAttribute(const Class::Member& member) {
+    if (!typedAttributes || !member.isAttribute || !member.cl) {
+        return "";
+    }
+    //simple types are typedefs of built-in types
+    const Class* cl = member.cl;
+    while (cl && !cl->isBuiltIn()) {
+        cl = (cl->isSimple() ? cl->base : NULL);
+    }
+    if (!cl) {
+        return "";
+    }
+    string type = cl->getCppClassname();
+    if (type == "std::string") {
+        return "std::pmr::string";
+    }
+    if (type == "double" || type == "int" || type == "bool") {
+        return type;
+    }
+    return "";
+}
+
+//returns the type of the member in the view of the class in a frozen document
+static string getFrozenType(const Class::Member& member) {
+    string type;
+    if (member.isAttribute) {
+      string typed = getTypedAttribute(member);
+      type = (typed.empty() || typed == "std::pmr::string" ? "std::string_view" : typed);
+    }
+    else {
+      string cl = (member.cl->isBuiltIn() ? "XMLObject" : cppNamespace + "::" + member.cl->getCppClassname());
+      if (member.isArray()) {
+        return "FrozenRange<" + cl + ", false>";
+      }
+      type = "Frozen<" + cl + ">";
+    }
+    return (member.isOptional() ? "std::optional< " + type + " >" : type);
+}
+
+//returns true if children are bound to the member by their element name rather than by the class of their object
+static bool isBoundByName(const Class::Member& member) {
+    return member.cl->isBuiltIn() || member.cl->isSimple();
+}
+
+//returns the root of the class hierarchy of a generated class
+static const Class* getRoot(const Class* cl) {
+    while (cl->base && !cl->base->isSimple()) {
+        cl = cl->base;
+    }
+    return cl;
+}
+
+//returns the bound member of a class in the members of a derived class, qualified by the class if a derived class hides the member
+static string getBoundMember(const list<const Class*>& hierarchy, const Class* owner, const Class::Member& member) {
+    bool derived = false;
+    for (const Class* c : hierarchy) {
+        if (derived) {
+            for (list<Class::Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+                if (it->cl && it->cppName == member.cppName) {
+                    return "members." + owner->getCppClassname() + "::Members::" + member.cppName;
+                }
+            }
+        }
+        derived = derived || (c == owner);
+    }
+    return "members." + member.cppName;
+}
+
+//returns the members of a class hierarchy satisfying the condition, grouped by the given key in order of appearance
+typedef vector< pair<const Class*, const Class::Member*> > BoundMembers;
+template<typename Condition, typename Key>
+static auto groupMembers(const list<const Class*>& hierarchy, Condition condition, Key key) {
+    vector< pair<decltype(key(declval<const Class::Member&>())), BoundMembers> > groups;
+    for (const Class* c : hierarchy) {
+        for (list<Class::Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            if (!it->cl || !condition(*it)) {
+                continue;
+            }
+            auto group = groups.begin();
+            while (group != groups.end() && group->first != key(*it)) {
+                group++;
+            }
+            if (group == groups.end()) {
+                group = groups.insert(groups.end(), { key(*it), {} });
+            }
+            group->second.push_back({ c, &*it });
+        }
+    }
+    return groups;
+}
+
+//writes the statement binding the position of a child to an element member
+static void writeBindChild(ostream& os, const string& indentation, const string& field, const Class::Member& member) {
+    if (member.isArray()) {
+        os << indentation << field << ".push_back(i);" << endl;
+    }
+    else {
+        os << indentation << "if ( !" << field << " ) " << field << " = i;" << endl;
+    }
+}
+
 Class::Class(FullName name, ClassType type) : name(name), cppName(sanitize(name.second)), type(type), 
-        isDocument(false), base(NULL), schema(schemaName)  {
+        isDocument(false), base(NULL), typeNumber(0), lastTypeNumber(0), schema(schemaName)  {
 }
 
 Class::Class(FullName name, ClassType type, FullName baseType) : name(name), cppName(sanitize(name.second)),
-        type(type), isDocument(false), baseType(baseType), base(NULL), schema(schemaName) {
+        type(type), isDocument(false), baseType(baseType), base(NULL), typeNumber(0), lastTypeNumber(0), schema(schemaName) {
 }
 
 Class::~Class() {
@@ -127,9 +231,183 @@ void Class::writeImplementation(ostream& os) const {
     os << endl;
 
     if (!isSimple()) {
-      os << getCppClassname() << "::" << getCppClassname() << "(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element, const Attributes& defaultAttributes) :" << endl;
+      ClassName cppName = getCppClassname();
+
+      if (hasBoundMembers()) {
+        //bind the members of the class and its base classes in a single pass over the attributes and a single pass over the children
+        list<const Class*> hierarchy = getHierarchy();
+        //the defaults are only used if an attribute member has a default
+        bool bindsDefaults = false;
+        for (const Class* c : hierarchy) {
+          for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            bindsDefaults = bindsDefaults || (it->cl && it->isAttribute && !it->defaultStr.empty());
+          }
+        }
+        os << cppName << "::Members " << cppName << "::bindMembers(ElementData& element, const Attributes&" << (bindsDefaults ? " defaultAttributes" : "") << ") {" << endl;
+        set<string> names;
+        for (const Class* c : hierarchy) {
+          for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            if (it->cl && (it->isAttribute || isBoundByName(*it)) && names.insert(it->cppName).second) {
+              os << "\tstatic const " << (it->isAttribute ? "AttributeName " : "ElementName ") << it->cppName << "Name(\"" << it->name << "\");" << endl;
+            }
+          }
+        }
+        os << "\tMembers members" << (hasArrayMembers() ? "(element.resource())" : "") << ";" << endl;
+
+        if (hasAttributeMembers()) {
+          os << "\tfor ( auto& attribute : element.attributes ) {" << endl;
+          bool first = true;
+          for (auto& group : groupMembers(hierarchy, [](const Member& member) { return member.isAttribute; }, [](const Member& member) { return member.name; })) {
+            os << "\t\t" << (first ? "" : "else ") << "if ( attribute.name == " << group.second.front().second->cppName << "Name ) {" << endl;
+            for (auto& [owner, member] : group.second) {
+              string field = getBoundMember(hierarchy, owner, *member);
+              string typed = getTypedAttribute(*member);
+              if (typed == "std::pmr::string") {
+                os << "\t\t\tif ( !" << field << " ) " << field << ".emplace(attribute.value.value, element.resource());" << endl;
+              }
+              else if (!typed.empty()) {
+                os << "\t\t\tif ( !" << field << " ) " << field << " = parseValue<" << typed << ">(attribute.value);" << endl;
+              }
+              else if (member->isOptional()) {
+                os << "\t\t\tif ( !" << field << " ) " << field << " = attribute;" << endl;
+              }
+              else {
+                os << "\t\t\tif ( !" << field << " ) " << field << " = &attribute;" << endl;
+              }
+            }
+            os << "\t\t}" << endl;
+            first = false;
+          }
+          os << "\t}" << endl;
+
+          //fall through to the defaults, whose positions are the same in the defaults of all derived classes
+          for (const Class* c : hierarchy) {
+            size_t position = c->getBaseDefaultsCount();
+            for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+              if (it->defaultStr.empty()) {
+                continue;
+              }
+              if (it->cl && it->isAttribute) {
+                string field = getBoundMember(hierarchy, c, *it);
+                string typed = getTypedAttribute(*it);
+                if (typed == "std::pmr::string") {
+                  os << "\tif ( !" << field << " ) " << field << ".emplace(defaultAttributes[" << position << "].value.value, element.resource());" << endl;
+                }
+                else if (!typed.empty()) {
+                  os << "\tif ( !" << field << " ) " << field << " = parseValue<" << typed << ">(defaultAttributes[" << position << "].value);" << endl;
+                }
+                else {
+                  os << "\tif ( !" << field << " ) " << field << " = " << (it->isOptional() ? "" : "&") << "defaultAttributes[" << position << "];" << endl;
+                }
+              }
+              position++;
+            }
+          }
+        }
+
+        if (hasElementMembers()) {
+          //children are bound by their position without creating their objects, which are created when a member is accessed if the XML-tree is created lazily
+          os << "\tfor ( uint32_t i = 0, size = (uint32_t)element.children.size(); i < size; i++ ) {" << endl;
+          //children of built-in types are bound by their interned element name
+          auto namedGroups = groupMembers(hierarchy, [](const Member& member) { return !member.isAttribute && isBoundByName(member); }, [](const Member& member) { return member.name; });
+          if (!namedGroups.empty()) {
+            os << "\t\tconst ElementName& name = element.children.nameOf(i);" << endl;
+          }
+          bool first = true;
+          for (auto& group : namedGroups) {
+            os << "\t\t" << (first ? "" : "else ") << "if ( name == " << group.second.front().second->cppName << "Name ) {" << endl;
+            for (auto& [owner, member] : group.second) {
+              writeBindChild(os, "\t\t\t", getBoundMember(hierarchy, owner, *member), *member);
+            }
+            os << "\t\t}" << endl;
+            first = false;
+          }
+
+          //children of generated classes are bound by the position of their class in its class hierarchy
+          auto groups = groupMembers(hierarchy, [](const Member& member) { return !member.isAttribute && !isBoundByName(member); }, [](const Member& member) { return getRoot(member.cl); });
+          if (!groups.empty()) {
+            os << "\t\tconst TypeId& type = element.children.typeOf(i);" << endl;
+          }
+          first = true;
+          for (auto& group : groups) {
+            const Class* root = group.first;
+            os << "\t\t" << (first ? "" : "else ") << "if ( type.hierarchy == &" << root->getCppClassname() << "::typeHierarchy ) {" << endl;
+            os << "\t\t\tswitch ( type.first ) {" << endl;
+            //classes of the hierarchy to which the same members are bound share their case
+            vector< pair< vector<size_t>, vector<unsigned int> > > cases;
+            for (unsigned int number = root->typeNumber; number <= root->lastTypeNumber; number++) {
+              vector<size_t> bound;
+              for (size_t i = 0; i < group.second.size(); i++) {
+                const Class* cl = group.second[i].second->cl;
+                if (cl->typeNumber <= number && number <= cl->lastTypeNumber) {
+                  bound.push_back(i);
+                }
+              }
+              if (bound.empty()) {
+                continue;
+              }
+              auto it = cases.begin();
+              while (it != cases.end() && it->first != bound) {
+                it++;
+              }
+              if (it == cases.end()) {
+                cases.push_back({ bound, { number } });
+              }
+              else {
+                it->second.push_back(number);
+              }
+            }
+            for (auto& [bound, numbers] : cases) {
+              for (unsigned int number : numbers) {
+                os << "\t\t\t\tcase " << number << ":" << endl;
+              }
+              for (size_t i : bound) {
+                auto& [owner, member] = group.second[i];
+                writeBindChild(os, "\t\t\t\t\t", getBoundMember(hierarchy, owner, *member), *member);
+              }
+              os << "\t\t\t\t\tbreak;" << endl;
+            }
+            os << "\t\t\t}" << endl;
+            os << "\t\t}" << endl;
+            first = false;
+          }
+          os << "\t}" << endl;
+        }
+
+        for (const Class* c : hierarchy) {
+          for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            if (it->cl && !it->isArray() && !it->isOptional()) {
+              os << "\tif ( !" << getBoundMember(hierarchy, c, *it) << " ) {" << endl;
+              if (it->isAttribute) {
+                os << "\t\tthrow std::runtime_error(\"Failed to get required attribute '" << it->name << "' of element '\" + std::string(element.elementName) + \"'\");" << endl;
+              }
+              else {
+                os << "\t\tthrow std::runtime_error(\"Failed to get required child of element '\" + std::string(element.elementName) + \"'\");" << endl;
+              }
+              os << "\t}" << endl;
+            }
+          }
+        }
+        os << "\treturn members;" << endl;
+        os << "}" << endl;
+        os << endl;
+
+        os << cppName << "::" << cppName << "(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes) :" << endl;
+        os << "\t" << cppName << "(xmlns, className, element, defaultAttributes, bindMembers(element, defaultAttributes))" << endl;
+        os << "{" << endl;
+        os << "}" << endl;
+        os << endl;
+
+        os << cppName << "::" << cppName << "(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes, Members&& members) :" << endl;
+      }
+      else {
+        os << cppName << "::" << cppName << "(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes) :" << endl;
+      }
+
       if (base) {
-        os << "\t" << base->getCppClassname() << "(xmlns, className, element, defaultAttributes)" << endl;
+        //members of the base classes are already bound
+        bool baseMembers = !base->isSimple() && base->hasBoundMembers();
+        os << "\t" << base->getCppClassname() << "(xmlns, className, element, defaultAttributes" << (baseMembers ? ", std::move(members)" : "") << ")" << endl;
       }
       else {
         os << "\tXMLObject(xmlns, className, element, defaultAttributes)" << endl;
@@ -140,42 +418,141 @@ void Class::writeImplementation(ostream& os) const {
           continue;
         }
 
-        if ( it->isAttribute ) {
-          if (it->isOptional() ) {
-            os << "\t, " << it->cppName << "(getOptionalAttributeByName(\"" << it->name<< "\"))" << endl;
-          }
-          else {
-            os << "\t, " << it->cppName << "(getRequiredAttributeByName(\"" << it->name<< "\"))" << endl;
-          }
+        if (!it->isAttribute) {
+          os << "\t, " << it->cppName << "(children, " << (it->isArray() ? "std::move(members." + it->cppName + ")" : (it->isOptional() ? "" : "*") + string("members.") + it->cppName) << ")" << endl;
         }
-        else if (!it->cl->isBuiltIn()) {
-          if (it->isArray()) {
-            os << "\t, " << it->cppName << "(getChildren<" << it->cl->getCppClassname() << ">())" << endl;
-          }
-          else if (it->isOptional() ) {
-            os << "\t, " << it->cppName << "(getOptionalChild<" << it->cl->getCppClassname() << ">())" << endl;
-          }
-          else {
-            os << "\t, " << it->cppName << "(getRequiredChild<" << it->cl->getCppClassname() << ">())" << endl;
-          }
+        else if (!getTypedAttribute(*it).empty() && it->isOptional()) {
+          os << "\t, " << it->cppName << "(std::move(members." << it->cppName << "))" << endl;
+        }
+        else if (!getTypedAttribute(*it).empty()) {
+          os << "\t, " << it->cppName << "(std::move(*members." << it->cppName << "))" << endl;
+        }
+        else if (it->isOptional() ) {
+          os << "\t, " << it->cppName << "(members." << it->cppName << ")" << endl;
         }
         else {
-          if (it->isArray()) {
-            os << "\t, " << it->cppName << "(getChildrenByName(\"" << it->name << "\"))" << endl;
+          os << "\t, " << it->cppName << "(*members." << it->cppName << ")" << endl;
+        }
+      }
+      os << "{" << endl;
+      //add the object to the ID index, if any
+      for (list<Member>::const_iterator it = members.begin(); it != members.end(); it++) {
+        if (!it->cl || !it->isAttribute || it->cl->name != FullName(XSL, "ID")) {
+          continue;
+        }
+        string id = (getTypedAttribute(*it).empty() ? (it->isOptional() ? it->cppName + "->get().value" : it->cppName + ".value") : (it->isOptional() ? "*" + it->cppName : it->cppName));
+        if (it->isOptional()) {
+          os << "\tif ( " << it->cppName << " ) addId(element, " << id << ", *this);" << endl;
+        }
+        else {
+          os << "\taddId(element, " << id << ", *this);" << endl;
+        }
+      }
+      os << "}" << endl;
+
+      //members of the view of the class in a frozen document
+      for (list<Member>::const_iterator it = members.begin(); it != members.end(); it++) {
+        if (!it->cl) {
+          continue;
+        }
+        os << endl;
+        os << getFrozenType(*it) << " Frozen<" << cppName << ">::" << it->cppName << "() const {" << endl;
+        if (it->isAttribute) {
+          os << "\tstatic const AttributeName " << it->cppName << "Name(\"" << it->name << "\");" << endl;
+          string typed = getTypedAttribute(*it);
+          if (typed.empty() || typed == "std::pmr::string") {
+            os << "\treturn get" << (it->isOptional() ? "Optional" : "Required") << "AttributeByName(" << it->cppName << "Name);" << endl;
           }
-          else if (it->isOptional() ) {
-            os << "\t, " << it->cppName << "(getOptionalChildByName(\"" << it->name << "\"))" << endl;
+          else if (it->isOptional()) {
+            os << "\tif ( auto value = getOptionalAttributeByName(" << it->cppName << "Name) ) {" << endl;
+            os << "\t\treturn parseValue<" << typed << ">(*value);" << endl;
+            os << "\t}" << endl;
+            os << "\treturn std::nullopt;" << endl;
           }
           else {
-            os << "\t, " << it->cppName << "(getRequiredChildByName(\"" << it->name << "\"))" << endl;
+            os << "\treturn parseValue<" << typed << ">(getRequiredAttributeByName(" << it->cppName << "Name));" << endl;
           }
         }
+        else if (!it->cl->isBuiltIn()) {
+          string cl = it->cl->getCppClassname();
+          os << "\treturn " << (it->isArray() ? "childrenOfType" : it->isOptional() ? "getOptionalChild" : "getRequiredChild") << "<" << cl << ">();" << endl;
+        }
+        else {
+          os << "\tstatic const ElementName " << it->cppName << "Name(\"" << it->name << "\");" << endl;
+          os << "\treturn " << (it->isArray() ? "childrenNamed" : it->isOptional() ? "getOptionalChildByName" : "getRequiredChildByName") << "(" << it->cppName << "Name);" << endl;
+        }
+        os << "}" << endl;
       }
-      os << "{" << endl;
-      os << "}" << endl;
     }
 }
 
+size_t Class::getBaseDefaultsCount() const {
+    size_t count = 0;
+    for (const Class* c = base; c; c = c->base) {
+        for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            if (!it->defaultStr.empty()) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+uint64_t Class::getFingerprint() const {
+    ostringstream definition;
+    definition << name.first << " " << name.second << " " << typeNumber << " " << lastTypeNumber;
+    for (const Class* c = this; c; c = c->base) {
+        definition << " : " << c->name.first << " " << c->name.second;
+        for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            definition << " " << it->name << " " << it->type.first << " " << it->type.second << " " << it->minOccurs << " " << it->maxOccurs << " " << it->isAttribute << " " << it->defaultStr;
+        }
+    }
+    //FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : definition.str()) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+list<const Class*> Class::getHierarchy() const {
+    list<const Class*> hierarchy;
+    for (const Class* c = this; c && !c->isSimple(); c = c->base) {
+        hierarchy.push_front(c);
+    }
+    return hierarchy;
+}
+
+//returns true if any member of the class or its base classes satisfies the condition
+template<typename Condition>
+static bool anyMember(const list<const Class*>& hierarchy, Condition condition) {
+    for (const Class* c : hierarchy) {
+        for (list<Class::Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+            if (it->cl && condition(*it)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Class::hasBoundMembers() const {
+    return anyMember(getHierarchy(), [](const Member&) { return true; });
+}
+
+bool Class::hasAttributeMembers() const {
+    return anyMember(getHierarchy(), [](const Member& member) { return member.isAttribute; });
+}
+
+bool Class::hasElementMembers() const {
+    return anyMember(getHierarchy(), [](const Member& member) { return !member.isAttribute; });
+}
+
+bool Class::hasArrayMembers() const {
+    return anyMember(getHierarchy(), [](const Member& member) { return !member.isAttribute && member.isArray(); });
+}
+
 void Class::writeHeader(ostream& os) const {
     ClassName className = getClassname();
     ClassName cppName = getCppClassname();
@@ -264,17 +641,67 @@ void Class::writeHeader(ostream& os) const {
 
         os << " {" << endl;
 
-        os << "\ttemplate<typename T> friend XMLObject* ::XML::createInstance(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element);" << endl; 
+        os << "\ttemplate<typename T> friend XMLObject* ::XML::createInstance(const Namespace& xmlns, const ClassName& className, ElementData& element);" << endl; 
 
         os << "private:" << endl;
 
         os << "\tstatic bool registerClass() {" << endl;
-        os << "\t\tXMLObject::factory[\"" << name.first << ":" << className << "\"] = &createInstance<" << cppName << ">; // register function in factory" << endl;
+        os << "\t\tXMLObject::factory[\"" << name.first << "\"][\"" << className << "\"] = { &createInstance<" << cppName << ">, &classType }; // register function and type id in factory" << endl;
+        os << "\t\tXMLObject::classTypes.emplace(\"" << className << "\", &classType); // register type id for queries" << endl;
+        os << "\t\tXMLObject::classFingerprints.emplace(&classType, 0x" << hex << getFingerprint() << dec << "ULL); // register fingerprint for snapshots" << endl;
         os << "\t\treturn true;" << endl;
         os << "\t};" << endl;
         os << "\tinline static bool registered = registerClass();" << endl;
+
+        if (hasBoundMembers()) {
+          //members of the class and its base classes are bound in a single pass over the attributes and children before the object is constructed
+          bool baseMembers = (base && !base->isSimple() && base->hasBoundMembers());
+          string baseStruct = (baseMembers ? base->getCppClassname() + "::Members" : "");
+          os << endl;
+          os << "protected:" << endl;
+          os << "\t/// attributes and child elements bound to the members of the object and of its base classes" << endl;
+          os << "\tstruct Members" << (baseMembers ? " : " + baseStruct : "") << " {" << endl;
+          if (hasArrayMembers()) {
+            os << "\t\tMembers(std::pmr::memory_resource* resource) :" << endl;
+            bool first = true;
+            if (baseMembers && base->hasArrayMembers()) {
+              os << "\t\t\t" << baseStruct << "(resource)" << endl;
+              first = false;
+            }
+            for (list<Member>::const_iterator it = members.begin(); it != members.end(); it++) {
+              if (it->cl && !it->isAttribute && it->isArray()) {
+                os << "\t\t\t" << (first ? "" : ", ") << it->cppName << "(resource)" << endl;
+                first = false;
+              }
+            }
+            os << "\t\t{};" << endl;
+          }
+          for (list<Member>::const_iterator it = members.begin(); it != members.end(); it++) {
+            if (!it->cl) {
+              continue;
+            }
+            std::string cppMember = (it->defaultStr.empty() ? "Attribute" : "const Attribute");
+            if (!getTypedAttribute(*it).empty()) {
+              os << "\t\tstd::optional<" << getTypedAttribute(*it) << "> " << it->cppName << ";" << endl;
+            }
+            else if (!it->isAttribute) {
+              //children are bound by their position
+              os << "\t\t" << (it->isArray() ? "std::pmr::vector<uint32_t> " : "std::optional<uint32_t> ") << it->cppName << ";" << endl;
+            }
+            else if (it->isOptional()) {
+              os << "\t\tstd::optional< std::reference_wrapper<" << cppMember << "> > " << it->cppName << ";" << endl;
+            }
+            else {
+              os << "\t\t" << cppMember << "* " << it->cppName << " = nullptr;" << endl;
+            }
+          }
+          os << "\t};" << endl;
+          os << "\t" << cppName << "(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes, Members&& members);" << endl;
+          os << "private:" << endl;
+          os << "\tstatic Members bindMembers(ElementData& element, const Attributes& defaultAttributes);" << endl;
+        }
         os << "protected:" << endl;
-        os << "\t" << cppName << "(const Namespace& xmlns, const ClassName& className, const xercesc::DOMElement* element, const Attributes& defaultAttributes);" << endl;
+        os << "\t" << cppName << "(const Namespace& xmlns, const ClassName& className, ElementData& element, const Attributes& defaultAttributes);" << endl;
         os << endl;
 
         if (friends.size()) {
@@ -288,14 +715,25 @@ void Class::writeHeader(ostream& os) const {
 
         os << "public:" << endl;
 
-        os << "\t/// default attributes to be used if they are not explicitly provided" << endl;
+        if (!base || base->isSimple()) {
+            os << "\t/// identifies the hierarchy of classes derived from " << cppName << endl;
+            os << "\tstatic constexpr char typeHierarchy = 0;" << endl;
+        }
+        os << "\t/// type id used to check whether an object is of this class or a derived class" << endl;
+        os << "\tstatic constexpr ClassType<" << cppName << "> classType = {{ &typeHierarchy, " << typeNumber << ", " << lastTypeNumber << " }};" << endl;
+        os << endl;
+
+        os << "\t/// default attributes to be used if they are not explicitly provided, defaults of base classes come first" << endl;
         os << "\tinline static const Attributes defaults = {";
         bool first = true;
 
-        // obtain all defaults including those from base classes
-        c = this;
-        while ( true ) {
-          for (list<Member>::const_iterator it = c->members.begin(); it != c->members.end(); it++) {
+        // obtain all defaults including those from base classes, such that each default has the same position for all derived classes
+        vector<const Class*> hierarchy;
+        for ( c = this; c; c = c->base ) {
+          hierarchy.insert(hierarchy.begin(), c);
+        }
+        for ( const Class* ancestor : hierarchy ) {
+          for (list<Member>::const_iterator it = ancestor->members.begin(); it != ancestor->members.end(); it++) {
             if ( !it->defaultStr.empty() ) {
               if (!first) os << ",";
               os << endl;
@@ -303,12 +741,6 @@ void Class::writeHeader(ostream& os) const {
               first = false; 
             }
           }
-          if ( c->base ) { 
-            c = c->base;
-          }
-          else { 
-            break;
-          }
         }
 
         os << endl;
@@ -324,35 +756,38 @@ void Class::writeHeader(ostream& os) const {
 
             os << "\t";
             if ( it->isAttribute ) {
+              //attributes with a default may refer to the immutable defaults of the class
+              std::string attribute = (it->defaultStr.empty() ? "Attribute" : "const Attribute");
+              if (!getTypedAttribute(*it).empty()) {
+                //typed attributes are parsed once when the object is created
+                if (it->isOptional()) {
+                  os << "std::optional<" << getTypedAttribute(*it) << "> " << it->cppName << "; ";
+                }
+                else {
+                  os << getTypedAttribute(*it) << " " << it->cppName << "; ";
+                }
+                os << "///< Value of attribute '" << it->name << "'" << endl;
+                continue;
+              }
 				      if (it->isOptional()) {
-                os << "std::optional< std::reference_wrapper<Attribute> > " << it->cppName << "; ";
+                os << "std::optional< std::reference_wrapper<" << attribute << "> > " << it->cppName << "; ";
               }
               else {
-                os << "Attribute& " << it->cppName << "; ";
+                os << attribute << "& " << it->cppName << "; ";
               }
               os << "///< Attribute value can be expected to be of type '" << (it->cl->isBuiltIn() ? it->cl->getClassname() : it->cl->base->getCppClassname()) << "'" << endl;
             }
-            else if (!it->cl->isBuiltIn()) {
-              std::string cppMember = (it->cl->isBuiltIn() ? it->cl->getClassname() : it->cl->getCppClassname());
-              if (it->isArray()) {
-                os << "std::vector< std::reference_wrapper<" << it->cl->getCppClassname() << "> > " << it->cppName << ";" << endl;
-              }
-              else if (it->isOptional()) {
-                os << "std::optional< std::reference_wrapper<" << it->cl->getCppClassname() << "> > " << it->cppName << ";" << endl;
-              }
-							else {
-                os << it->cl->getCppClassname() << "& " << it->cppName << ";" << endl;
-              }
-            }
             else {
+              //members for child elements refer to the children by their position
+              std::string cppMember = (it->cl->isBuiltIn() ? "XMLObject" : it->cl->getCppClassname());
               if (it->isArray()) {
-                os << "std::vector< std::reference_wrapper<XMLObject> > " << it->cppName << ";" << endl;
+                os << "ChildList<" << cppMember << "> " << it->cppName << ";" << endl;
               }
               else if (it->isOptional()) {
-                os << "std::optional< std::reference_wrapper<XMLObject> > " << it->cppName << ";" << endl;
+                os << "OptionalChild<" << cppMember << "> " << it->cppName << ";" << endl;
               }
 							else {
-                os << "XMLObject& " << it->cppName << ";" << endl;
+                os << "RequiredChild<" << cppMember << "> " << it->cppName << ";" << endl;
               }
             }
         }
@@ -361,6 +796,30 @@ void Class::writeHeader(ostream& os) const {
         os << endl;
         os << "} // namespace XML::" << cppNamespace << endl;
 
+        //view of the class in a frozen document
+        os << endl;
+        os << "namespace XML {" << endl;
+        os << endl;
+        string frozenBase = (base && !base->isSimple() ? "Frozen<" + cppNamespace + "::" + base->getCppClassname() + ">" : "Frozen<XMLObject>");
+        os << "/// @brief View of an element of class " << cppNamespace << "::" << cppName << " in a frozen document" << endl;
+        os << "template<> class Frozen<" << cppNamespace << "::" << cppName << "> : public " << frozenBase << " {" << endl;
+        os << "public:" << endl;
+        os << "\tFrozen(const FrozenDocument& document, uint32_t index) : " << frozenBase << "(document, index) {};" << endl;
+        bool frozenMembers = false;
+        for (list<Member>::const_iterator it = members.begin(); it != members.end(); it++) {
+          if (!it->cl) {
+            continue;
+          }
+          if (!frozenMembers) {
+            os << endl;
+            frozenMembers = true;
+          }
+          os << "\t" << getFrozenType(*it) << " " << it->cppName << "() const; ///< " << (it->isAttribute ? "Value of attribute '" : "Child element(s) '") << it->name << "'" << endl;
+        }
+        os << "};" << endl;
+        os << endl;
+        os << "} // namespace XML" << endl;
+
     }
 
     os << endl;
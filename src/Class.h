@@ -27,6 +27,7 @@
 #include <list>
 #include <set>
 #include <limits.h>
+#include <cstdint>
 
 #define UNBOUNDED INT_MAX
 #define XSL "http://www.w3.org/2001/XMLSchema"
@@ -103,6 +104,10 @@ public:
     FullName baseType;
     Class *base;
 
+    //depth-first number of the class in its class hierarchy and largest number of its derived classes
+    unsigned int typeNumber;
+    unsigned int lastTypeNumber;
+
     bool hasBase() const;
     
     std::list<Member> members;
@@ -142,6 +147,32 @@ public:
      */
     virtual bool hasHeader() const;
 
+    /**
+     * Returns the class and the base classes from which its generated class is derived, base classes first.
+     */
+    std::list<const Class*> getHierarchy() const;
+
+    /**
+     * Returns whether the class or any of its base classes has members of a known class which are bound when an
+     * object is created, members which are attributes, members which are elements, or members which are arrays of elements.
+     */
+    bool hasBoundMembers() const;
+    bool hasAttributeMembers() const;
+    bool hasElementMembers() const;
+    bool hasArrayMembers() const;
+
+    /**
+     * Returns the number of defaults of all base classes, i.e., the position of the first default
+     * of this class in the defaults of this class and its derived classes.
+     */
+    size_t getBaseDefaultsCount() const;
+
+    /**
+     * Returns a hash of the definitions of the class and its base classes including the type ids,
+     * which changes whenever the class is generated differently.
+     */
+    uint64_t getFingerprint() const;
+
     void writeImplementation(std::ostream& os) const;
     void writeHeader(std::ostream& os) const;
 };
@@ -55,9 +55,10 @@ using namespace schematicpp;
 static void printUsage() {
     cerr << "schematic++ v" << VERSION << endl;
     cerr << endl;
-    cerr << "USAGE: schematic++ [-v] [-s] -n <namespace> -o <output-dir> -i <schema_1> ... <schema_n>" << endl;
+    cerr << "USAGE: schematic++ [-v] [-s] [-t] -n <namespace> -o <output-dir> -i <schema_1> ... <schema_n>" << endl;
     cerr << " -v\tVerbose mode" << endl;
     cerr << " -s\tSimulate generation but don't write anything to disk" << endl;
+    cerr << " -t\tGenerate typed members for attributes of built-in types" << endl;
     cerr << " -n\tProvide C++ namespace" << endl;
     cerr << " -o\tProvide output directory" << endl;
     cerr << " -i\tProvide list of XML schema definition files" << endl;
@@ -78,6 +79,7 @@ map<FullName, Class*> classes;
 map<FullName, Class*> groups;
 
 bool verbose = false;
+bool typedAttributes = false;
 std::string schemaName;
 vector<string> schemaNames;
 std::string cppNamespace;
@@ -575,12 +577,50 @@ static void work(string outputDir) {
     }
 }
 
+static void assignTypeNumbers(Class* cl, map<Class*, list<Class*> >& derived, unsigned int& number) {
+    cl->typeNumber = number++;
+    for (list<Class*>::iterator it = derived[cl].begin(); it != derived[cl].end(); it++) {
+        assignTypeNumbers(*it, derived, number);
+    }
+    cl->lastTypeNumber = number - 1;
+}
+
+/**
+ * Numbers the classes of each class hierarchy in depth-first order.
+ * A class is derived from another class if its number lies between the number of the other class
+ * and the largest number of the classes derived from the other class.
+ */
+static void assignTypeNumbers() {
+    map<Class*, list<Class*> > derived;
+    list<Class*> roots;
+
+    for (map<FullName, Class*>::iterator it = classes.begin(); it != classes.end(); it++) {
+        Class* cl = it->second;
+        if (cl->isBuiltIn() || cl->isSimple()) {
+            continue;
+        }
+        if (cl->base && !cl->base->isSimple()) {
+            derived[cl->base].push_back(cl);
+        }
+        else {
+            roots.push_back(cl);
+        }
+    }
+
+    for (list<Class*>::iterator it = roots.begin(); it != roots.end(); it++) {
+        unsigned int number = 0;
+        assignTypeNumbers(*it, derived, number);
+    }
+}
+
 void doPostResolveInits() {
     if (verbose) cerr << "Doing post-resolve work in preparation for writing headers and implementations." << endl;
 
     for (map<FullName, Class*>::iterator it = classes.begin(); it != classes.end(); it++) {
         it->second->doPostResolveInit();
     }
+
+    assignTypeNumbers();
 }
 
 /**
@@ -704,6 +744,10 @@ int main_wrapper(int argc, char** argv) {
                 dry_run = true;
                 if (verbose) cerr << "Simulate generation" << endl;
             } 
+            else if (!strcmp(argv[0], "-t")) {
+                typedAttributes = true;
+                if (verbose) cerr << "Typed attributes" << endl;
+            } 
             else if (!strcmp(argv[0], "-n") && argc > 1 && argv[1][0] != '-') {
                 argv++;
                 argc--;